@@ -1,26 +1,33 @@
 #include <iostream>
 #include <iomanip>
 #include <vector>
-#include <list>
 #include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <string>
+#include <chrono>
+#include <climits>
+#include "cache_model.h"
+#include "shards.h"
+#include "golden.h"
 using namespace std;
+using namespace cachelib;
 
 #define DRAM_SIZE       (64 * 1024 * 1024) // 64 MB
 #define CACHE_SIZE      (64 * 1024)        // 64 KB
 #define NUM_REFERENCES  1000000
+#define BATCH_SIZE      4096               // references generated per accessBatch() call
 
-enum cacheResType { MISS = 0, HIT = 1 };
-struct CacheLine {
-    unsigned int tag;
-    bool valid;
-};
-
-vector<vector<CacheLine>> cache;
-vector<list<int>> lruLists;
+// Simulated cache, rebuilt by initCache()
+CacheModel model(1, 1, 64);
 int numSets;
 int numWays;
 int lineSize;
 
+TimingConfig timing;
+
 // Random number generator
 unsigned int m_w = 0xABABAB55;
 unsigned int m_z = 0x05080902;
@@ -32,15 +39,18 @@ unsigned int rand_()
 }
 
 // Memory reference generators
+unsigned int gen1Addr = 0;
+unsigned int gen4Addr = 0;
+unsigned int gen5Addr = 0;
+unsigned int gen6Addr = 0;
+
 unsigned int memGen1()
 {
-    static unsigned int addr = 0;
-    return (addr++) % (DRAM_SIZE);
+    return (gen1Addr++) % (DRAM_SIZE);
 }
 
 unsigned int memGen2()
 {
-    static unsigned int addr = 0;
     return rand_() % (24 * 1024);  //24 KB
 }
 
@@ -51,134 +61,482 @@ unsigned int memGen3()
 
 unsigned int memGen4()
 {
-    static unsigned int addr = 0;
-    return (addr++) % (4 * 1024); // 4KB
+    return (gen4Addr++) % (4 * 1024); // 4KB
 }
 
 unsigned int memGen5()
 {
-    static unsigned int addr = 0;
-    return (addr++) % (1024 * 64); //64 KB
+    return (gen5Addr++) % (1024 * 64); //64 KB
 }
 
 unsigned int memGen6()
 {
-    static unsigned int addr = 0;
-    return (addr += 32) % (64 * 4 * 1024);
+    return (gen6Addr += 32) % (64 * 4 * 1024);
+}
+
+// Parameterized workload generators
+enum workloadKind { ZIPF, MATRIX, POINTER_CHASE, MEMGEN };
+enum matrixOrder { ROW_MAJOR, COLUMN_MAJOR, BLOCKED };
+
+struct Workload {
+    workloadKind kind;
+    unsigned int cursor;          // position in the pattern, cleared by resetMemGens()
+    bool dependent;               // each address is read from the previous reference's data
+
+    // Zipf: hot keys over a footprint of fixed-size items
+    vector<double> zipfCdf;
+    unsigned int itemSize;
+
+    // Matrix: row-major array of rows x cols elements, walked in the given order
+    matrixOrder order;
+    unsigned int rows;
+    unsigned int cols;
+    unsigned int elemSize;
+    unsigned int tile;
+
+    // Pointer chasing: one random cycle through every node
+    vector<unsigned int> nextNode;
+    unsigned int nodeSize;
+
+    // One of memGen1 - memGen6
+    unsigned int (*memGen)();
+};
+
+// Zipfian accesses over `footprint` bytes: item k is touched with weight 1 / (k+1)^alpha
+void initZipf(Workload& w, unsigned int footprint, double alpha, unsigned int itemSize) {
+    w.kind = ZIPF;
+    w.cursor = 0;
+    w.dependent = false;
+    w.itemSize = itemSize;
+
+    unsigned int items = max(1u, min(footprint, (unsigned int)DRAM_SIZE) / itemSize);
+    w.zipfCdf.resize(items);
+    double sum = 0;
+    for (unsigned int k = 0; k < items; ++k) {
+        sum += 1.0 / pow(k + 1.0, alpha);
+        w.zipfCdf[k] = sum;
+    }
+    for (double& p : w.zipfCdf)
+        p /= sum;
+}
+
+// Matrix traversal; BLOCKED walks tile x tile sub-blocks, so rows and cols must be multiples of tile
+void initMatrix(Workload& w, unsigned int rows, unsigned int cols, unsigned int elemSize, matrixOrder order, unsigned int tile) {
+    w.kind = MATRIX;
+    w.cursor = 0;
+    w.dependent = false;
+    w.order = order;
+    w.rows = rows;
+    w.cols = cols;
+    w.elemSize = elemSize;
+    w.tile = order == BLOCKED ? tile : 1;
+}
+
+// Linked structure of `nodes` nodes laid out in memory, visited in a random cyclic order
+void initPointerChase(Workload& w, unsigned int nodes, unsigned int nodeSize) {
+    w.kind = POINTER_CHASE;
+    w.cursor = 0;
+    w.dependent = true;
+    w.nodeSize = nodeSize;
+
+    // Sattolo's algorithm - a random permutation that is a single cycle
+    w.nextNode.resize(nodes);
+    for (unsigned int i = 0; i < nodes; ++i)
+        w.nextNode[i] = i;
+    for (unsigned int i = nodes - 1; i > 0; --i)
+        swap(w.nextNode[i], w.nextNode[rand_() % i]);
+}
+
+void initMemGen(Workload& w, unsigned int (*memGen)()) {
+    w.kind = MEMGEN;
+    w.cursor = 0;
+    w.dependent = false;
+    w.memGen = memGen;
+}
+
+unsigned int nextAddr(Workload& w) {
+    switch (w.kind) {
+    case ZIPF: {
+        double u = rand_() / 4294967296.0;
+        unsigned int rank = lower_bound(w.zipfCdf.begin(), w.zipfCdf.end(), u) - w.zipfCdf.begin();
+        unsigned int items = w.zipfCdf.size();
+        rank = min(rank, items - 1);
+        // Scatter ranks so hot keys are not all neighbours in memory
+        unsigned int item = (unsigned long long)rank * 2654435761u % items;
+        return item * w.itemSize;
+    }
+    case MATRIX: {
+        unsigned int i = w.cursor;
+        w.cursor = (w.cursor + 1) % ((unsigned long long)w.rows * w.cols);
+
+        unsigned int row, col;
+        if (w.order == ROW_MAJOR) {
+            row = i / w.cols;
+            col = i % w.cols;
+        }
+        else if (w.order == COLUMN_MAJOR) {
+            row = i % w.rows;
+            col = i / w.rows;
+        }
+        else {
+            unsigned int tileArea = w.tile * w.tile;
+            unsigned int tileIndex = i / tileArea;
+            unsigned int inTile = i % tileArea;
+            unsigned int tilesPerRow = w.cols / w.tile;
+            row = (tileIndex / tilesPerRow) * w.tile + inTile / w.tile;
+            col = (tileIndex % tilesPerRow) * w.tile + inTile % w.tile;
+        }
+        return (((unsigned long long)row * w.cols + col) * w.elemSize) % DRAM_SIZE;
+    }
+    case POINTER_CHASE: {
+        unsigned int node = w.cursor;
+        w.cursor = w.nextNode[node];
+        return ((unsigned long long)node * w.nodeSize) % DRAM_SIZE;
+    }
+    default:
+        return w.memGen();
+    }
+}
+
+Workload zipfWorkload;
+Workload matrixWorkload;
+Workload chaseWorkload;
+
+unsigned int memGenZipf()
+{
+    return nextAddr(zipfWorkload);
+}
+
+unsigned int memGenMatrix()
+{
+    return nextAddr(matrixWorkload);
+}
+
+unsigned int memGenChase()
+{
+    return nextAddr(chaseWorkload);
+}
+
+// Phase mixing: each phase issues its references, then hands over to the next, looping at the end
+struct Phase {
+    Workload workload;
+    unsigned int references;
+};
+
+vector<Phase> phases;
+size_t currentPhase = 0;
+unsigned int phaseRefs = 0;
+
+unsigned int memGenPhases()
+{
+    Phase& phase = phases[currentPhase];
+    unsigned int addr = nextAddr(phase.workload);
+    if (++phaseRefs == phase.references) {
+        phaseRefs = 0;
+        currentPhase = (currentPhase + 1) % phases.size();
+    }
+    return addr;
 }
 
-// Reset static variables
+// Load phases from a spec file, one phase per line:
+//   <generator> <references> [key=value ...]
+// generator is zipf (footprint, alpha, item), matrix (rows, cols, elem, order=row|col|blocked, tile),
+// chase (nodes, node) or memGen1 - memGen6. '#' starts a comment.
+bool loadPhaseSpec(const string& path) {
+    ifstream in(path);
+    if (!in) {
+        cerr << "Cannot open phase spec " << path << endl;
+        return false;
+    }
+
+    vector<Phase> loaded;
+    unsigned int (*memGens[])() = { memGen1, memGen2, memGen3, memGen4, memGen5, memGen6 };
+    string line;
+    int lineNo = 0;
+    while (getline(in, line)) {
+        lineNo++;
+        line = line.substr(0, line.find('#'));
+        istringstream fields(line);
+        string generator;
+        long long references = 0;
+        if (!(fields >> generator))
+            continue;
+        if (!(fields >> references) || references <= 0 || references > UINT_MAX) {
+            cerr << path << ":" << lineNo << ": expected a reference count between 1 and " << UINT_MAX << endl;
+            return false;
+        }
+
+        map<string, string> params;
+        string field;
+        while (fields >> field) {
+            size_t eq = field.find('=');
+            if (eq == string::npos) {
+                cerr << path << ":" << lineNo << ": expected key=value, got " << field << endl;
+                return false;
+            }
+            params[field.substr(0, eq)] = field.substr(eq + 1);
+        }
+        auto param = [&](const string& key, const string& def) {
+            auto it = params.find(key);
+            string value = it == params.end() ? def : it->second;
+            if (it != params.end())
+                params.erase(it);
+            return value;
+        };
+
+        Phase phase;
+        phase.references = references;
+        try {
+            if (generator == "zipf") {
+                unsigned long long item = stoull(param("item", "64"));
+                unsigned long long footprint = stoull(param("footprint", "1048576"));
+                if (item == 0 || item > DRAM_SIZE) {
+                    cerr << path << ":" << lineNo << ": zipf item size must be between 1 and " << DRAM_SIZE << endl;
+                    return false;
+                }
+                initZipf(phase.workload, min(footprint, (unsigned long long)DRAM_SIZE), stod(param("alpha", "0.99")), item);
+            }
+            else if (generator == "matrix") {
+                string order = param("order", "row");
+                unsigned long long rows = stoull(param("rows", "512"));
+                unsigned long long cols = stoull(param("cols", "512"));
+                unsigned long long elem = stoull(param("elem", "8"));
+                unsigned long long tile = stoull(param("tile", "32"));
+                if (rows == 0 || cols == 0 || elem == 0) {
+                    cerr << path << ":" << lineNo << ": matrix needs at least one row and column of non-empty elements" << endl;
+                    return false;
+                }
+                // Checked one factor at a time so the product cannot overflow
+                if (rows > DRAM_SIZE || cols > DRAM_SIZE / rows || elem > DRAM_SIZE / (rows * cols)) {
+                    cerr << path << ":" << lineNo << ": matrix is larger than the " << DRAM_SIZE << "-byte memory" << endl;
+                    return false;
+                }
+                if (order != "row" && order != "col" && order != "blocked") {
+                    cerr << path << ":" << lineNo << ": unknown matrix order " << order << endl;
+                    return false;
+                }
+                if (tile == 0 || tile > DRAM_SIZE) {
+                    cerr << path << ":" << lineNo << ": tile must be between 1 and " << DRAM_SIZE << endl;
+                    return false;
+                }
+                if (order == "blocked" && (rows % tile != 0 || cols % tile != 0)) {
+                    cerr << path << ":" << lineNo << ": rows and cols must be multiples of tile" << endl;
+                    return false;
+                }
+                initMatrix(phase.workload, rows, cols, elem,
+                    order == "row" ? ROW_MAJOR : order == "col" ? COLUMN_MAJOR : BLOCKED, tile);
+            }
+            else if (generator == "chase") {
+                unsigned long long nodes = stoull(param("nodes", "16384"));
+                unsigned long long node = stoull(param("node", "64"));
+                if (nodes == 0 || node == 0) {
+                    cerr << path << ":" << lineNo << ": chase needs at least one non-empty node" << endl;
+                    return false;
+                }
+                if (nodes > DRAM_SIZE || node > DRAM_SIZE / nodes) {
+                    cerr << path << ":" << lineNo << ": chase list is larger than the " << DRAM_SIZE << "-byte memory" << endl;
+                    return false;
+                }
+                initPointerChase(phase.workload, nodes, node);
+            }
+            else if (generator.size() == 7 && generator.compare(0, 6, "memGen") == 0
+                && generator[6] >= '1' && generator[6] <= '6') {
+                initMemGen(phase.workload, memGens[generator[6] - '1']);
+            }
+            else {
+                cerr << path << ":" << lineNo << ": unknown generator " << generator << endl;
+                return false;
+            }
+        }
+        catch (const exception&) {
+            cerr << path << ":" << lineNo << ": bad numeric parameter" << endl;
+            return false;
+        }
+
+        if (!params.empty()) {
+            cerr << path << ":" << lineNo << ": unknown parameter " << params.begin()->first << endl;
+            return false;
+        }
+        loaded.push_back(phase);
+    }
+
+    if (loaded.empty()) {
+        cerr << path << ": no phases" << endl;
+        return false;
+    }
+    phases = loaded;
+    return true;
+}
+
+// Reset generator state so every run sees the same reference stream
 void resetMemGens() {
     m_w = 0xABABAB55;
     m_z = 0x05080902;
+
+    gen1Addr = gen4Addr = gen5Addr = gen6Addr = 0;
+    zipfWorkload.cursor = 0;
+    matrixWorkload.cursor = 0;
+    chaseWorkload.cursor = 0;
+    for (auto& phase : phases)
+        phase.workload.cursor = 0;
+    currentPhase = 0;
+    phaseRefs = 0;
 }
 
 // Initialize Cache
-void initCache(int sets, int ways, int blockSize) {
+void initCache(int sets, int ways, int blockSize, replacementPolicy policy = LRU) {
     numSets = sets;
     numWays = ways;
     lineSize = blockSize;
+    model = CacheModel(sets, ways, blockSize, timing, policy);
+}
 
-    cache.clear();
-    lruLists.clear();
-
-    cache.resize(numSets, vector<CacheLine>(numWays, { 0, false }));
-    lruLists.resize(numSets);
+// Initialize TLB: one {sets, ways} pair per level, first entry is L1
+void initTLB(const vector<pair<int, int>>& levels, int pageBytes, bool injectWalks) {
+    model.configureTLB(levels, pageBytes, injectWalks);
 }
 
 // Cache Simulator
 cacheResType cacheSim(unsigned int addr) {
-    unsigned int blockAddr = addr / lineSize;
-    unsigned int index = blockAddr % numSets;
-    unsigned int tag = blockAddr / numSets;
-
-    auto& set = cache[index];
-    auto& lru = lruLists[index];
-
-    // Check for hit
-    for (int i = 0; i < numWays; ++i) {
-        if (set[i].valid && set[i].tag == tag) {
-            // Update LRU - remove and add to front
-            lru.remove(i);
-            lru.push_front(i);
-            return HIT;
-        }
+    return model.access(addr);
+}
+
+// Generate NUM_REFERENCES addresses a batch at a time, handing each batch to sink(addrs, count)
+template <typename Gen, typename Sink>
+void fillBatch(Gen memGen, Sink sink) {
+    vector<unsigned int> batch(BATCH_SIZE);
+    for (int done = 0; done < NUM_REFERENCES; done += batch.size()) {
+        size_t count = min(batch.size(), (size_t)(NUM_REFERENCES - done));
+        for (size_t i = 0; i < count; ++i)
+            batch[i] = memGen();
+        sink(batch.data(), count);
     }
+}
 
-    // Miss - find empty slot 
-    int replaceIndex = -1;
+// Feed NUM_REFERENCES addresses from a generator through the cache
+void runReferences(unsigned int (*memGen)()) {
+    fillBatch(memGen, [](const unsigned int* addrs, size_t count) { model.accessBatch(addrs, count); });
+}
 
-    // Look for invalid line first
-    for (int i = 0; i < numWays; ++i) {
-        if (!set[i].valid) {
-            replaceIndex = i;
-            break;
-        }
+// Experiment configurations, shared with the regression harness
+const vector<int> lineSizeList = { 16, 32, 64, 128 };                  // Experiment 1, 4 sets
+const vector<int> waysList = { 1, 2, 4, 8, 16 };                       // Experiment 2, 64B lines
+const vector<int> pageSizeList = { PAGE_4KB, PAGE_2MB, PAGE_1GB };     // Experiment 3
+const vector<pair<int, int>> tlbGeometry = { { 16, 4 }, { 128, 12 } }; // 64-entry L1, 1536-entry L2
+const vector<int> partitionList = { 0, 8, 12, 14 };                    // Experiment 5, tenant 0 ways (0 = shared)
+const vector<int> mshrList = { 1, 2, 4, 8, 16, 32 };                   // Experiment 6
+
+void runLineSizeConfig(unsigned int (*memGen)(), int blockSize) {
+    const int fixedSets = 4;
+    resetMemGens();
+    initCache(fixedSets, CACHE_SIZE / (fixedSets * blockSize), blockSize);
+    runReferences(memGen);
+}
+
+void runWaysConfig(unsigned int (*memGen)(), int ways) {
+    const int fixedLineSize = 64;
+    resetMemGens();
+    initCache(CACHE_SIZE / (ways * fixedLineSize), ways, fixedLineSize);
+    runReferences(memGen);
+}
+
+void runPageSizeConfig(unsigned int (*memGen)(), int pageBytes) {
+    const int fixedLineSize = 64;
+    const int fixedWays = 4;
+    resetMemGens();
+    initCache(CACHE_SIZE / (fixedWays * fixedLineSize), fixedWays, fixedLineSize);
+    initTLB(tlbGeometry, pageBytes, true);
+    runReferences(memGen);
+}
+
+// Two tenants alternate references on a 16-way cache; tenant 1 lives above DRAM_SIZE
+// so neither tenant can hit on the other's data
+void runPartitionConfig(unsigned int (*memGenA)(), unsigned int (*memGenB)(), int waysForA) {
+    const int fixedLineSize = 64;
+    const int fixedWays = 16;
+    resetMemGens();
+    initCache(CACHE_SIZE / (fixedWays * fixedLineSize), fixedWays, fixedLineSize);
+    if (waysForA > 0) {
+        model.setWayMask(0, (1ull << waysForA) - 1);
+        model.setWayMask(1, ((1ull << fixedWays) - 1) & ~((1ull << waysForA) - 1));
     }
 
-    // If no invalid line, use LRU
-    if (replaceIndex == -1) {
-        if (lru.size() < numWays) {
-            // Find a way that's not in the LRU list
-            for (int i = 0; i < numWays; ++i) {
-                if (find(lru.begin(), lru.end(), i) == lru.end()) {
-                    replaceIndex = i;
-                    break;
-                }
-            }
-        }
-        else {
-            replaceIndex = lru.back();
-            lru.pop_back();
+    // BATCH_SIZE is even, so every batch starts with tenant 0
+    vector<int> tenants(BATCH_SIZE);
+    for (size_t i = 0; i < tenants.size(); ++i)
+        tenants[i] = i % 2;
+    int next = 0;
+    fillBatch([&] { return next++ % 2 == 0 ? memGenA() : memGenB() + 2 * DRAM_SIZE; },
+        [&](const unsigned int* addrs, size_t count) { model.accessBatch(addrs, count, nullptr, nullptr, tenants.data()); });
+}
+
+// Whether memGen's next reference is read from the previous one's data (pointer chasing);
+// for a phase mix this is the current phase's workload
+bool dependentLoads(unsigned int (*memGen)()) {
+    if (memGen == memGenChase)
+        return chaseWorkload.dependent;
+    if (memGen == memGenPhases)
+        return phases[currentPhase].workload.dependent;
+    return false;
+}
+
+void runMSHRConfig(unsigned int (*memGen)(), int entries) {
+    const int fixedLineSize = 64;
+    const int fixedWays = 4;
+    resetMemGens();
+    initCache(CACHE_SIZE / (fixedWays * fixedLineSize), fixedWays, fixedLineSize);
+    model.configureMSHRs(entries, dependentLoads(memGen));
+    if (memGen == memGenPhases) {
+        // Dependence can change at any phase boundary, so references go one at a time
+        for (int i = 0; i < NUM_REFERENCES; ++i) {
+            model.setDependentLoads(dependentLoads(memGen));
+            model.access(memGen());
         }
     }
+    else
+        runReferences(memGen);
+    model.drainMSHRs();
+}
 
-    // Update cache
-    set[replaceIndex].tag = tag;
-    set[replaceIndex].valid = true;
-
-    // Update LRU
-    lru.remove(replaceIndex); // Remove if exists
-    lru.push_front(replaceIndex);
+// Miss-ratio curve sizes, 4KB - 4MB
+const unsigned int mrcMinSize = 4 * 1024;
+const unsigned int mrcMaxSize = 4 * 1024 * 1024;
 
-    return MISS;
+ShardsMRC runMRCConfig(unsigned int (*memGen)()) {
+    const int fixedLineSize = 64;
+    // 512B buckets over the sizes the curve is read at
+    resetMemGens();
+    ShardsMRC mrc(fixedLineSize, 32768, 1.0, 2 * mrcMaxSize, 16384);
+    fillBatch(memGen, [&](const unsigned int* addrs, size_t count) { mrc.accessBatch(addrs, count); });
+    return mrc;
 }
 
 // Experiment 1: Fix sets to 4, vary line size
 void experimentVaryLineSize(unsigned int (*memGen)(), const string& genName) {
-    vector<int> lineSizes = { 16, 32, 64, 128 };
     const int fixedSets = 4;
     vector<pair<int, double>> results;
 
     cout << "\n--- Experiment 1: Vary Line Size (Fixed Sets = 4) with " << genName << " ---\n";
 
-    for (int blockSize : lineSizes) {
+    for (int blockSize : lineSizeList) {
         int ways = CACHE_SIZE / (fixedSets * blockSize);
-        resetMemGens();
-        initCache(fixedSets, ways, blockSize);
-
-        unsigned int hits = 0, misses = 0;
-        for (int i = 0; i < NUM_REFERENCES; ++i) {
-            unsigned int addr = memGen();
-            if (cacheSim(addr) == HIT)
-                hits++;
-            else
-                misses++;
-        }
+        runLineSizeConfig(memGen, blockSize);
 
-        double hitRatio = 100.0 * hits / NUM_REFERENCES;
-        double missRatio = 100.0 * misses / NUM_REFERENCES;
+        const CacheStats& stats = model.stats();
+        double hitRatio = 100.0 * stats.hits / NUM_REFERENCES;
+        double missRatio = 100.0 * stats.misses / NUM_REFERENCES;
         results.push_back({ blockSize, hitRatio });
 
         cout << "Line size: " << blockSize << " bytes, Ways: " << ways
             << ", Hit ratio: " << fixed << setprecision(4) << hitRatio
-            << "%, Miss ratio: " << missRatio << "%" << endl;
+            << "%, Miss ratio: " << missRatio
+            << "%, AMAT: " << setprecision(2) << (double)stats.cycles / NUM_REFERENCES
+            << " cycles, Total cycles: " << stats.cycles << endl;
     }
 }
 
 // Experiment 2: Fix line size to 64B, vary ways
 void experimentVaryWays(unsigned int (*memGen)(), const string& genName) {
-    vector<int> waysList = { 1, 2, 4, 8, 16 };
     const int fixedLineSize = 64;
     vector<pair<int, double>> results;
 
@@ -186,30 +544,141 @@ void experimentVaryWays(unsigned int (*memGen)(), const string& genName) {
 
     for (int ways : waysList) {
         int sets = CACHE_SIZE / (ways * fixedLineSize);
-        resetMemGens();
-        initCache(sets, ways, fixedLineSize);
+        runWaysConfig(memGen, ways);
 
-        unsigned int hits = 0, misses = 0;
-        for (int i = 0; i < NUM_REFERENCES; ++i) {
-            unsigned int addr = memGen();
-            if (cacheSim(addr) == HIT)
-                hits++;
-            else
-                misses++;
-        }
-
-        double hitRatio = 100.0 * hits / NUM_REFERENCES;
-        double missRatio = 100.0 * misses / NUM_REFERENCES;
+        const CacheStats& stats = model.stats();
+        double hitRatio = 100.0 * stats.hits / NUM_REFERENCES;
+        double missRatio = 100.0 * stats.misses / NUM_REFERENCES;
         results.push_back({ ways, hitRatio });
 
         cout << "Ways: " << ways << ", Sets: " << sets
             << ", Hit ratio: " << fixed << setprecision(4) << hitRatio
-            << "%, Miss ratio: " << missRatio << "%" << endl;
+            << "%, Miss ratio: " << missRatio
+            << "%, AMAT: " << setprecision(2) << (double)stats.cycles / NUM_REFERENCES
+            << " cycles, Total cycles: " << stats.cycles << endl;
+    }
+}
+
+// Experiment 3: Fix cache to 64B lines / 4 ways, vary page size behind a two-level TLB
+void experimentVaryPageSize(unsigned int (*memGen)(), const string& genName) {
+    cout << "\n--- Experiment 3: Vary Page Size (64B lines, 4 ways, L1 TLB 16x4, L2 TLB 128x12) with " << genName << " ---\n";
+
+    for (int pageBytes : pageSizeList) {
+        runPageSizeConfig(memGen, pageBytes);
+
+        const CacheStats& stats = model.stats();
+        const vector<TLBLevel>& tlb = model.tlbLevels();
+        cout << "Page size: " << (pageBytes >= PAGE_1GB ? to_string(pageBytes >> 30) + "GB"
+            : pageBytes >= PAGE_2MB ? to_string(pageBytes >> 20) + "MB" : to_string(pageBytes >> 10) + "KB")
+            << fixed << setprecision(4);
+        for (size_t l = 0; l < tlb.size(); ++l) {
+            unsigned long long lookups = tlb[l].hits + tlb[l].misses;
+            cout << ", L" << l + 1 << " TLB hit ratio: " << (lookups ? 100.0 * tlb[l].hits / lookups : 0.0) << "%";
+        }
+        cout << ", Page walks: " << stats.pageWalks
+            << ", Walk refs: " << stats.walkRefs
+            << " (" << (stats.walkRefs ? 100.0 * stats.walkHits / stats.walkRefs : 0.0) << "% cache hits)"
+            << ", Data hit ratio: " << 100.0 * stats.hits / NUM_REFERENCES
+            << "%, Data miss ratio: " << 100.0 * stats.misses / NUM_REFERENCES
+            << "%, Translation cycles: " << stats.tlbCycles
+            << ", AMAT: " << setprecision(2) << (double)(stats.cycles + stats.tlbCycles) / NUM_REFERENCES
+            << " cycles, Total cycles: " << stats.cycles + stats.tlbCycles << endl;
+    }
+}
+
+// Experiment 4: Approximate miss-ratio curve (fully associative LRU, 64B lines) in one sampled pass
+void experimentMissRatioCurve(unsigned int (*memGen)(), const string& genName) {
+    cout << "\n--- Experiment 4: Miss-Ratio Curve (SHARDS, 64B lines) with " << genName << " ---\n";
+
+    ShardsMRC mrc = runMRCConfig(memGen);
+
+    // Below about 16 sampled blocks the estimate depends on which few blocks were sampled
+    unsigned int firstSize = mrcMinSize;
+    while (firstSize < 16 * mrc.samplingStep() && firstSize < mrcMaxSize)
+        firstSize *= 2;
+
+    cout << "Sampling rate: " << fixed << setprecision(4) << mrc.samplingRate()
+        << ", Tracked blocks: " << mrc.trackedBlocks() << ", Bytes per sampled block: "
+        << setprecision(0) << mrc.samplingStep() << setprecision(4) << endl;
+    for (unsigned int size = firstSize; size <= mrcMaxSize; size *= 2) {
+        cout << "Cache size: " << size / 1024 << " KB, Miss ratio: "
+            << 100.0 * mrc.missRatio(size) << "%" << endl;
+    }
+}
+
+// Experiment 5: Two tenants interleaved on a 64KB, 16-way cache, with and without way partitioning
+void experimentWayPartitioning(unsigned int (*memGenA)(), const string& nameA, unsigned int (*memGenB)(), const string& nameB) {
+    const int fixedLineSize = 64;
+    const int fixedWays = 16;
+    const int sets = CACHE_SIZE / (fixedWays * fixedLineSize);
+
+    cout << "\n--- Experiment 5: Way Partitioning (64B lines, 16 ways) with tenant 0 = " << nameA
+        << ", tenant 1 = " << nameB << " ---\n";
+
+    for (int split : partitionList) {
+        runPartitionConfig(memGenA, memGenB, split);
+
+        if (split > 0)
+            cout << "Ways: " << split << "/" << fixedWays - split;
+        else
+            cout << "Ways: shared";
+        const vector<TenantStats>& tenantStats = model.tenantStats();
+        for (size_t t = 0; t < tenantStats.size(); ++t) {
+            const TenantStats& ts = tenantStats[t];
+            unsigned long long refs = ts.hits + ts.misses;
+            cout << ", Tenant " << t << " hit ratio: " << fixed << setprecision(4)
+                << (refs ? 100.0 * ts.hits / refs : 0.0)
+                << "%, occupancy: " << 100.0 * ts.occupancy / (sets * fixedWays) << "%";
+        }
+        cout << ", Overall hit ratio: " << 100.0 * model.stats().hits / NUM_REFERENCES << "%" << endl;
+    }
+}
+
+// Experiment 6: Non-blocking cache (64B lines, 4 ways), vary the number of MSHRs
+void experimentVaryMSHRs(unsigned int (*memGen)(), const string& genName) {
+    bool dependentPhases = memGen == memGenPhases
+        && any_of(phases.begin(), phases.end(), [](const Phase& p) { return p.workload.dependent; });
+    cout << "\n--- Experiment 6: Vary MSHRs (64B lines, 4 ways, one reference issued per cycle) with " << genName
+        << (dependentPhases ? " (dependent loads in chase phases)" : dependentLoads(memGen) ? " (dependent loads)" : "")
+        << " ---\n";
+
+    for (int entries : mshrList) {
+        runMSHRConfig(memGen, entries);
+
+        const CacheStats& stats = model.stats();
+        cout << "MSHRs: " << entries
+            << ", Miss ratio: " << fixed << setprecision(4) << 100.0 * stats.misses / NUM_REFERENCES
+            << "%, Merged misses: " << stats.mergedMisses
+            << ", MSHR-full stalls: " << stats.mshrFullStalls
+            << " (" << stats.mshrStallCycles << " cycles)"
+            << ", MLP: " << setprecision(2) << stats.mlp()
+            << ", Cycles: " << stats.mshrCycles
+            << " (blocking: " << stats.cycles << ")" << endl;
     }
 }
 
 
 // Test cases for validation
+int checksRun = 0;
+int checksFailed = 0;
+
+void check(bool ok, const string& what) {
+    checksRun++;
+    if (!ok) {
+        checksFailed++;
+        cout << "FAIL: " << what << endl;
+    }
+}
+
+// Compare a test's hit/miss sequence with the expected one
+void checkSequence(const string& test, const vector<cacheResType>& results, const vector<cacheResType>& expected) {
+    string got, want;
+    for (cacheResType res : results)
+        got += res == HIT ? "H" : "M";
+    for (cacheResType res : expected)
+        want += res == HIT ? "H" : "M";
+    check(got == want, test + ": expected " + want + ", got " + got);
+}
 
 void testConflictMiss() {
     cout << "\n--- Test Case: Conflict Miss ---\n";
@@ -234,16 +703,20 @@ void testConflictMiss() {
         baseAddr + 3 * sets * lineSize
     };
 
+    vector<cacheResType> results;
     cout << "First round - all should be MISS:" << endl;
     for (unsigned int addr : addresses) {
         cacheResType res = cacheSim(addr);
+        results.push_back(res);
         cout << "Access " << addr << ": " << (res == HIT ? "HIT" : "MISS") << endl;
     }
     cout << "\nSecond round - all should be MISS due to conflict evictions EXCEPT the first one (the last one present in the last round is now first accessed this round and matches the tag ):" << endl;
     for (int i = addresses.size() - 1; i >= 0; i--) {
         cacheResType res = cacheSim(addresses[i]);
+        results.push_back(res);
         cout << "Re-access " << addresses[i] << ": " << (res == HIT ? "HIT" : "MISS") << endl;
     }
+    checkSequence("Conflict Miss (direct-mapped)", results, { MISS, MISS, MISS, MISS, HIT, MISS, MISS, MISS });
 
     // Now test with 2-way set associative cache (should handle conflicts better)
     ways = 2;
@@ -255,18 +728,21 @@ void testConflictMiss() {
     cout << "Number of Sets: " << sets << endl;
     cout << "Number of Ways: " << ways << endl;
 
+    results.clear();
     cout << "\nFirst round - all should be MISS:" << endl;
     for (unsigned int addr : addresses) {
         cacheResType res = cacheSim(addr);
+        results.push_back(res);
         cout << "Access " << addr << ": " << (res == HIT ? "HIT" : "MISS") << endl;
     }
 
     cout << "\nSecond round - all should be HIT with 2-way cache:" << endl;
     for (unsigned int addr : addresses) {
         cacheResType res = cacheSim(addr);
+        results.push_back(res);
         cout << "Re-access " << addr << ": " << (res == HIT ? "HIT" : "MISS") << endl;
     }
-
+    checkSequence("Conflict Miss (2-way)", results, { MISS, MISS, MISS, MISS, HIT, HIT, HIT, HIT });
 }
 
 void testSequentialAccess() {
@@ -287,9 +763,11 @@ void testSequentialAccess() {
 
 
     // Access sequential addresses within the same cache line
+    vector<cacheResType> results;
     for (int i = 0; i < 10; i++) {
         unsigned int addr = 1000 + i;
         cacheResType result = cacheSim(addr);
+        results.push_back(result);
         if (result == HIT) hits++;
         else misses++;
         cout << "Access " << addr << ": " << (result == HIT ? "HIT" : "MISS") << endl;
@@ -297,7 +775,7 @@ void testSequentialAccess() {
 
     cout << "Sequential access within same line - Hits: " << hits << ", Misses: " << misses << endl;
     cout << "Hit Ratio: " << fixed << setprecision(2) << (100.0 * hits / (hits + misses)) << "%" << endl;
-
+    checkSequence("Sequential Access", results, { MISS, HIT, HIT, HIT, HIT, HIT, HIT, HIT, HIT, HIT });
 }
 
 void testRepeatedAccess() {
@@ -319,8 +797,10 @@ void testRepeatedAccess() {
     // Access pattern that should cause hits after first access
     unsigned int addresses[] = { 1000, 2000, 1000, 2000, 1000, 2000 };
 
+    vector<cacheResType> results;
     for (unsigned int addr : addresses) {
         cacheResType result = cacheSim(addr);
+        results.push_back(result);
         if (result == HIT) hits++;
         else misses++;
         cout << "Access " << addr << ": " << (result == HIT ? "HIT" : "MISS") << endl;
@@ -328,6 +808,7 @@ void testRepeatedAccess() {
 
     cout << "Repeated access - Hits: " << hits << ", Misses: " << misses << endl;
     cout << "Hit Ratio: " << fixed << setprecision(2) << (100.0 * hits / (hits + misses)) << "%" << endl;
+    checkSequence("Repeated Access", results, { MISS, MISS, HIT, HIT, HIT, HIT });
 }
 
 void testPerfectHit() {
@@ -345,15 +826,19 @@ void testPerfectHit() {
 
     // Access a few unique addresses that all fit in the cache
     vector<unsigned int> addresses = { 0, 64, 128, 192 }; // different lines //selected to be mapped to different lines to avoid conflict misses
+    vector<cacheResType> results;
     for (unsigned int addr : addresses) {
         cacheResType res = cacheSim(addr);
+        results.push_back(res);
         cout << "Access " << addr << ": " << (res == HIT ? "HIT" : "MISS") << endl;
     }
 
     for (unsigned int addr : addresses) {
         cacheResType res = cacheSim(addr);
+        results.push_back(res);
         cout << "Access " << addr << ": " << (res == HIT ? "HIT" : "MISS") << endl;
     }
+    checkSequence("Perfect Hit", results, { MISS, MISS, MISS, MISS, HIT, HIT, HIT, HIT });
 }
 
 
@@ -382,40 +867,424 @@ void testLRUPolicy() {
 
     cout << "Expected sequence: MISS, MISS, HIT, MISS, MISS, MISS\n";
 
-    cout << "Access " << addr1 << ": " << (cacheSim(addr1) == HIT ? "HIT" : "MISS") << " cold start" << endl;
-    cout << "Access " << addr2 << ": " << (cacheSim(addr2) == HIT ? "HIT" : "MISS") << " cold start" << endl;
-    cout << "Access " << addr1 << ": " << (cacheSim(addr1) == HIT ? "HIT" : "MISS") << endl;
-    cout << "Access " << addr3 << ": " << (cacheSim(addr3) == HIT ? "HIT" : "MISS") << " 33088 is LRU so it is evicted and replaced by 65856" << endl;
-    cout << "Access " << addr2 << ": " << (cacheSim(addr2) == HIT ? "HIT" : "MISS") << " 33088 is not in the set any more (evicted) so it will overwrite 320 (LRU so evicted)" << endl;
-    cout << "Access " << addr1 << ": " << (cacheSim(addr1) == HIT ? "HIT" : "MISS") << " 320 not in the set anymore so it overwrites 65856(gets evicted using LRU)" << endl;
+    vector<cacheResType> results;
+    results.push_back(cacheSim(addr1));
+    cout << "Access " << addr1 << ": " << (results.back() == HIT ? "HIT" : "MISS") << " cold start" << endl;
+    results.push_back(cacheSim(addr2));
+    cout << "Access " << addr2 << ": " << (results.back() == HIT ? "HIT" : "MISS") << " cold start" << endl;
+    results.push_back(cacheSim(addr1));
+    cout << "Access " << addr1 << ": " << (results.back() == HIT ? "HIT" : "MISS") << endl;
+    results.push_back(cacheSim(addr3));
+    cout << "Access " << addr3 << ": " << (results.back() == HIT ? "HIT" : "MISS") << " 33088 is LRU so it is evicted and replaced by 65856" << endl;
+    results.push_back(cacheSim(addr2));
+    cout << "Access " << addr2 << ": " << (results.back() == HIT ? "HIT" : "MISS") << " 33088 is not in the set any more (evicted) so it will overwrite 320 (LRU so evicted)" << endl;
+    results.push_back(cacheSim(addr1));
+    cout << "Access " << addr1 << ": " << (results.back() == HIT ? "HIT" : "MISS") << " 320 not in the set anymore so it overwrites 65856(gets evicted using LRU)" << endl;
     cout << " Now set 5 contains addresses 320 and 33088" << endl;
+    checkSequence("LRU Replacement Policy", results, { MISS, MISS, HIT, MISS, MISS, MISS });
+}
+
+// The same trace in one 2-way set under each policy; A is used twice, B three times
+void testReplacementPolicies() {
+    cout << "\n--- Test Case: LRU/LFU/FIFO/RANDOM Replacement ---\n";
+
+    int lineSize = 64;
+    int ways = 2;
+    int sets = CACHE_SIZE / (ways * lineSize);
+    unsigned int a = 5 * lineSize;
+    unsigned int b = a + sets * lineSize;
+    unsigned int c = b + sets * lineSize;
+    cout << "Test Description: A B B B A C B A B in one set of a " << ways << "-way cache\n";
+
+    const char* names[] = { "LRU", "LFU", "FIFO", "RANDOM" };
+    // C evicts B under LRU (least recent), A under LFU (fewer uses) and A under FIFO (filled first)
+    vector<vector<cacheResType>> expected = {
+        { MISS, MISS, HIT, HIT, HIT, MISS, MISS, MISS, HIT },
+        { MISS, MISS, HIT, HIT, HIT, MISS, HIT, MISS, HIT },
+        { MISS, MISS, HIT, HIT, HIT, MISS, HIT, MISS, MISS },
+        { MISS, MISS, HIT, HIT, HIT, MISS },
+    };
+    for (int policy = LRU; policy <= RANDOM; ++policy) {
+        initCache(sets, ways, lineSize, (replacementPolicy)policy);
+        vector<cacheResType> results;
+        for (unsigned int addr : { a, b, b, b, a, c, b, a, b })
+            results.push_back(cacheSim(addr));
+
+        // RANDOM is only fixed up to the first eviction
+        results.resize(expected[policy].size());
+        string seq;
+        for (cacheResType res : results)
+            seq += res == HIT ? "H" : "M";
+        cout << names[policy] << ": " << seq << endl;
+        checkSequence(string(names[policy]) + " Replacement Policy", results, expected[policy]);
+    }
+}
+
+void testMSHRResetStats() {
+    cout << "\n--- Test Case: Non-blocking Cycles After resetStats() ---\n";
+
+    int lineSize = 64;
+    int ways = 4;
+    int sets = CACHE_SIZE / (ways * lineSize);
+    cout << "Cache Type: " << ways << "-Way Set Associative, 4 MSHRs" << endl;
+    cout << "Test Description: 100 misses, reset, then 10 hits; the reset must restart the cycle count\n";
+    initCache(sets, ways, lineSize);
+    model.configureMSHRs(4);
+
+    for (unsigned int i = 0; i < 100; i++)
+        cacheSim(i * lineSize);
+    model.drainMSHRs();
+    cout << "Cycles before reset: " << model.stats().mshrCycles << endl;
+
+    model.resetStats();
+    for (unsigned int i = 0; i < 10; i++)
+        cacheSim(i * lineSize);
+    model.drainMSHRs();
+    // One hit issues per cycle, the last one's data arrives hitCycles after it issues
+    unsigned long long expected = 9 + model.hitCycles();
+    const CacheStats& stats = model.stats();
+    cout << "Cycles after reset: " << stats.mshrCycles << " (expected " << expected << "), Hits: " << stats.hits << endl;
+    check(stats.mshrCycles == expected && stats.hits == 10 && stats.outstandingCycles == 0,
+        "Non-blocking reset: expected " + to_string(expected) + " cycles and 10 hits, got "
+        + to_string(stats.mshrCycles) + " cycles and " + to_string(stats.hits) + " hits");
+}
+
+void testDependentLoadsMatchBlocking() {
+    cout << "\n--- Test Case: Dependent Loads Without Overlap ---\n";
+
+    int lineSize = 64;
+    int ways = 4;
+    int sets = CACHE_SIZE / (ways * lineSize);
+    cout << "Cache Type: " << ways << "-Way Set Associative, 4 MSHRs, dependent loads" << endl;
+    cout << "Test Description: 100 misses then 100 hits, each waiting for the one before; no miss can overlap,\n"
+        << "so the non-blocking cycles must equal the blocking ones\n";
+    initCache(sets, ways, lineSize);
+    model.configureMSHRs(4, true);
+
+    for (int pass = 0; pass < 2; pass++) {
+        for (unsigned int i = 0; i < 100; i++)
+            cacheSim(i * lineSize);
+    }
+    model.drainMSHRs();
+    const CacheStats& stats = model.stats();
+    cout << "Blocking cycles: " << stats.cycles << ", non-blocking cycles: " << stats.mshrCycles << endl;
+    check(stats.mshrCycles == stats.cycles && stats.hits == 100,
+        "Dependent loads: expected " + to_string(stats.cycles) + " cycles and 100 hits, got "
+        + to_string(stats.mshrCycles) + " cycles and " + to_string(stats.hits) + " hits");
+}
+
+// Generators used by the experiments; setup (if any) must run before the generator is used
+struct Generator {
+    string name;
+    unsigned int (*memGen)();
+    void (*setup)();
+};
+
+void setupZipf() {
+    initZipf(zipfWorkload, 1024 * 1024, 0.99, 64); // 1 MB of 64B keys
+}
+
+void setupMatrixColumnMajor() {
+    initMatrix(matrixWorkload, 512, 512, 8, COLUMN_MAJOR, 1); // 2 MB of doubles
+}
+
+void setupMatrixBlocked() {
+    initMatrix(matrixWorkload, 512, 512, 8, BLOCKED, 32);
+}
+
+void setupChase() {
+    resetMemGens(); // the chain is drawn from rand_(), start it from the same seed every time
+    initPointerChase(chaseWorkload, 16384, 64); // 1 MB linked list
+}
+
+const vector<Generator> generators = {
+    { "memGen1", memGen1, nullptr },
+    { "memGen2", memGen2, nullptr },
+    { "memGen3", memGen3, nullptr },
+    { "memGen4", memGen4, nullptr },
+    { "memGen5", memGen5, nullptr },
+    { "memGen6", memGen6, nullptr },
+    { "memGenZipf", memGenZipf, setupZipf },
+    { "memGenMatrix (column-major)", memGenMatrix, setupMatrixColumnMajor },
+    { "memGenMatrix (blocked 32x32)", memGenMatrix, setupMatrixBlocked },
+    { "memGenChase", memGenChase, setupChase },
+};
+
+// Tenant pairs for Experiment 5, by generator name
+const vector<pair<string, string>> partitionPairs = { { "memGen2", "memGen3" }, { "memGenZipf", "memGenChase" } };
+
+const Generator* findGenerator(const string& name) {
+    for (const Generator& gen : generators) {
+        if (gen.name == name)
+            return &gen;
+    }
+    return nullptr;
+}
+
+// Regression harness: every experiment configuration is re-run and its exact counters are
+// compared with golden.h; the same runs are timed against throughput floors.
+// param is the line size (Experiment 1), ways (2), page size (3), tenant 0 ways (5) or MSHRs (6);
+// Experiment 4 has one run per generator (param 0). values holds, per experiment:
+//   1, 2: hits, misses, cycles
+//   3:    hits, misses, TLB cycles, page walks, walk refs, walk hits, then hits and misses per TLB level
+//   4:    tracked blocks, sampling threshold (rate * 2^24), then the miss ratio in parts per
+//         million (the precision Experiment 4 prints) for each size from mrcMinSize to mrcMaxSize
+//   5:    hits, misses and occupancy of tenant 0, then of tenant 1
+//   6:    hits, misses, MSHR cycles, merged misses, MSHR-full stalls, stall cycles,
+//         outstanding sum, outstanding cycles (MLP is their ratio)
+struct RegressionRun {
+    int experiment;
+    string generator;
+    int param;
+    vector<unsigned long long> values;
+    double seconds;
+};
+
+// Minimum references/second per configuration for its slowest generator, set to about a quarter
+// of what an -O2 build measures so that only real slowdowns trip them, not machine noise.
+// Experiment 1 with small lines is slow by design: 4 sets of up to 1024 ways.
+struct ThroughputFloor {
+    int experiment;
+    int param;
+    double refsPerSecond;
+};
+
+const vector<ThroughputFloor> throughputFloors = {
+    { 1, 16, 30000 },
+    { 1, 32, 60000 },
+    { 1, 64, 150000 },
+    { 1, 128, 400000 },
+    { 2, 1, 1500000 },
+    { 2, 2, 1500000 },
+    { 2, 4, 1500000 },
+    { 2, 8, 1200000 },
+    { 2, 16, 1000000 },
+    { 3, PAGE_4KB, 750000 },
+    { 3, PAGE_2MB, 1000000 },
+    { 3, PAGE_1GB, 1000000 },
+    { 4, 0, 1000000 },
+    { 5, 0, 1500000 },
+    { 5, 8, 1500000 },
+    { 5, 12, 1500000 },
+    { 5, 14, 1500000 },
+    { 6, 1, 1200000 },
+    { 6, 2, 1200000 },
+    { 6, 4, 1200000 },
+    { 6, 8, 1100000 },
+    { 6, 16, 1000000 },
+    { 6, 32, 800000 },
+};
+
+// Counters of the cache model after a run, as listed with RegressionRun
+vector<unsigned long long> modelValues(int experiment) {
+    const CacheStats& stats = model.stats();
+    vector<unsigned long long> values;
+    if (experiment == 5) {
+        const vector<TenantStats>& tenantStats = model.tenantStats();
+        for (size_t t = 0; t < 2; ++t) {
+            TenantStats ts = t < tenantStats.size() ? tenantStats[t] : TenantStats();
+            values.insert(values.end(), { ts.hits, ts.misses, ts.occupancy });
+        }
+        return values;
+    }
+
+    values = { stats.hits, stats.misses };
+    if (experiment == 1 || experiment == 2)
+        values.push_back(stats.cycles);
+    else if (experiment == 3) {
+        values.insert(values.end(), { stats.tlbCycles, stats.pageWalks, stats.walkRefs, stats.walkHits });
+        for (const TLBLevel& level : model.tlbLevels())
+            values.insert(values.end(), { level.hits, level.misses });
+    }
+    else if (experiment == 6) {
+        values.insert(values.end(), { stats.mshrCycles, stats.mergedMisses, stats.mshrFullStalls,
+            stats.mshrStallCycles, stats.outstandingSum, stats.outstandingCycles });
+    }
+    return values;
+}
+
+vector<unsigned long long> mrcValues(const ShardsMRC& mrc) {
+    vector<unsigned long long> values = { mrc.trackedBlocks(), (unsigned long long)llround(mrc.samplingRate() * (1 << 24)) };
+    for (unsigned int size = mrcMinSize; size <= mrcMaxSize; size *= 2)
+        values.push_back(llround(mrc.missRatio(size) * 1e6));
+    return values;
+}
 
+template <typename Run>
+void timeRun(vector<RegressionRun>& runs, int experiment, const string& generator, int param, Run run) {
+    auto start = chrono::steady_clock::now();
+    vector<unsigned long long> values = run();
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    runs.push_back({ experiment, generator, param, values, elapsed.count() });
 }
 
-int main() {
+vector<RegressionRun> runRegression() {
+    vector<RegressionRun> runs;
+
+    for (const Generator& gen : generators) {
+        if (gen.setup)
+            gen.setup();
+        for (int blockSize : lineSizeList)
+            timeRun(runs, 1, gen.name, blockSize, [&] { runLineSizeConfig(gen.memGen, blockSize); return modelValues(1); });
+        for (int ways : waysList)
+            timeRun(runs, 2, gen.name, ways, [&] { runWaysConfig(gen.memGen, ways); return modelValues(2); });
+        for (int pageBytes : pageSizeList)
+            timeRun(runs, 3, gen.name, pageBytes, [&] { runPageSizeConfig(gen.memGen, pageBytes); return modelValues(3); });
+        timeRun(runs, 4, gen.name, 0, [&] { return mrcValues(runMRCConfig(gen.memGen)); });
+        for (int entries : mshrList)
+            timeRun(runs, 6, gen.name, entries, [&] { runMSHRConfig(gen.memGen, entries); return modelValues(6); });
+    }
+
+    for (auto& tenants : partitionPairs) {
+        const Generator* genA = findGenerator(tenants.first);
+        const Generator* genB = findGenerator(tenants.second);
+        if (!genA || !genB) {
+            check(false, "Experiment 5: unknown generator in " + tenants.first + "/" + tenants.second);
+            continue;
+        }
+        const Generator& a = *genA;
+        const Generator& b = *genB;
+        if (a.setup)
+            a.setup();
+        if (b.setup)
+            b.setup();
+        for (int split : partitionList)
+            timeRun(runs, 5, a.name + "/" + b.name, split,
+                [&] { runPartitionConfig(a.memGen, b.memGen, split); return modelValues(5); });
+    }
+    return runs;
+}
+
+string formatValues(const vector<unsigned long long>& values) {
+    string text;
+    for (size_t i = 0; i < values.size(); ++i)
+        text += (i ? ", " : "") + to_string(values[i]);
+    return text;
+}
+
+// Print golden.h for the current model, after an intended change in results
+void printGolden(const vector<RegressionRun>& runs) {
+    cout << "#ifndef GOLDEN_H\n#define GOLDEN_H\n\n#include <vector>\n\n"
+        << "// Expected results for ./cache_simulator --check, regenerate with ./cache_simulator --golden > golden.h\n"
+        << "// param and values are described with RegressionRun in cache.cpp\n"
+        << "struct GoldenResult {\n    int experiment;\n    const char* generator;\n    int param;\n"
+        << "    std::vector<unsigned long long> values;\n};\n\n"
+        << "const std::vector<GoldenResult> goldenResults = {\n";
+    for (const RegressionRun& r : runs)
+        cout << "    { " << r.experiment << ", \"" << r.generator << "\", " << r.param << ", { "
+            << formatValues(r.values) << " } },\n";
+    cout << "};\n\n#endif\n";
+}
+
+void checkGolden(const vector<RegressionRun>& runs) {
+    map<string, const GoldenResult*> golden;
+    for (const GoldenResult& g : goldenResults)
+        golden[to_string(g.experiment) + ", " + g.generator + ", " + to_string(g.param)] = &g;
+
+    for (const RegressionRun& r : runs) {
+        string key = to_string(r.experiment) + ", " + r.generator + ", " + to_string(r.param);
+        auto it = golden.find(key);
+        if (it == golden.end()) {
+            check(false, "Experiment " + key + ": no golden result");
+            continue;
+        }
+        const GoldenResult& g = *it->second;
+        check(r.values == g.values, "Experiment " + key + ": expected { " + formatValues(g.values)
+            + " }, got { " + formatValues(r.values) + " }");
+    }
+    check(runs.size() == goldenResults.size(), "golden.h has " + to_string(goldenResults.size())
+        + " results, the harness ran " + to_string(runs.size()) + " configurations");
+}
+
+// Compare the slowest generator of each configuration with its floor
+void checkThroughput(const vector<RegressionRun>& runs) {
+    cout << "\n--- Throughput (references/second, slowest generator) ---\n";
+    for (const ThroughputFloor& floor : throughputFloors) {
+        double slowest = 0;
+        string slowestGen;
+        for (const RegressionRun& r : runs) {
+            double rate = NUM_REFERENCES / max(r.seconds, 1e-9);
+            if (r.experiment == floor.experiment && r.param == floor.param && (slowestGen.empty() || rate < slowest)) {
+                slowest = rate;
+                slowestGen = r.generator;
+            }
+        }
+        if (slowestGen.empty())
+            continue;
+        cout << "Experiment " << floor.experiment << ", param " << floor.param << ": " << fixed << setprecision(0)
+            << slowest << " (" << slowestGen << "), floor: " << floor.refsPerSecond << endl;
+        check(slowest >= floor.refsPerSecond, "Experiment " + to_string(floor.experiment) + ", param "
+            + to_string(floor.param) + " with " + slowestGen + " is below its throughput floor");
+    }
+}
+
+void runTests() {
     testPerfectHit();
     testSequentialAccess();
     testRepeatedAccess();
     testLRUPolicy();
     testConflictMiss();
+    testReplacementPolicies();
+    testMSHRResetStats();
+    testDependentLoadsMatchBlocking();
+}
 
-    experimentVaryLineSize(memGen1, "memGen1");
-    experimentVaryWays(memGen1, "memGen1");
-
-    experimentVaryLineSize(memGen2, "memGen2");
-    experimentVaryWays(memGen2, "memGen2");
+int main(int argc, char* argv[]) {
+    string mode = argc > 1 ? argv[1] : "";
+
+    // --check-results (make check) runs the test cases and compares every experiment with golden.h;
+    // --check (make perf-check) adds the wall-clock throughput floors
+    if (mode == "--check" || mode == "--check-results") {
+        runTests();
+        vector<RegressionRun> runs = runRegression();
+        checkGolden(runs);
+        if (mode == "--check")
+            checkThroughput(runs);
+        cout << "\n" << checksRun - checksFailed << "/" << checksRun << " checks passed" << endl;
+        return checksFailed ? 1 : 0;
+    }
+    if (mode == "--golden") {
+        printGolden(runRegression());
+        return 0;
+    }
 
-    experimentVaryLineSize(memGen3, "memGen3");
-    experimentVaryWays(memGen3, "memGen3");
+    // A phase spec on the command line runs only the experiments for that workload mix
+    if (argc > 1) {
+        if (!loadPhaseSpec(argv[1]))
+            return 1;
+        experimentVaryLineSize(memGenPhases, argv[1]);
+        experimentVaryWays(memGenPhases, argv[1]);
+        experimentVaryPageSize(memGenPhases, argv[1]);
+        experimentMissRatioCurve(memGenPhases, argv[1]);
+        experimentVaryMSHRs(memGenPhases, argv[1]);
+        return 0;
+    }
 
-    experimentVaryLineSize(memGen4, "memGen4");
-    experimentVaryWays(memGen4, "memGen4");
+    runTests();
 
-    experimentVaryLineSize(memGen5, "memGen5");
-    experimentVaryWays(memGen5, "memGen5");
+    for (const Generator& gen : generators) {
+        if (gen.setup)
+            gen.setup();
+        experimentVaryLineSize(gen.memGen, gen.name);
+        experimentVaryWays(gen.memGen, gen.name);
+        experimentVaryPageSize(gen.memGen, gen.name);
+        experimentMissRatioCurve(gen.memGen, gen.name);
+        experimentVaryMSHRs(gen.memGen, gen.name);
+    }
 
-    experimentVaryLineSize(memGen6, "memGen6");
-    experimentVaryWays(memGen6, "memGen6");
+    for (auto& tenants : partitionPairs) {
+        const Generator* a = findGenerator(tenants.first);
+        const Generator* b = findGenerator(tenants.second);
+        if (!a || !b) {
+            cerr << "Experiment 5: unknown generator in " << tenants.first << "/" << tenants.second << endl;
+            return 1;
+        }
+        if (a->setup)
+            a->setup();
+        if (b->setup)
+            b->setup();
+        experimentWayPartitioning(a->memGen, a->name, b->memGen, b->name);
+    }
 
     return 0;
 }
@@ -0,0 +1,639 @@
+#include "cache_model.h"
+#include "cache_model_c.h"
+
+#include <algorithm>
+#include <new>
+using namespace std;
+using namespace cachelib;
+
+// Integer log2 for power-of-two geometry values
+static int log2i(int value) {
+    int bits = 0;
+    while (value > 1) {
+        value >>= 1;
+        bits++;
+    }
+    return bits;
+}
+
+static bool isPow2(int value) {
+    return value > 0 && (value & (value - 1)) == 0;
+}
+
+#define ALL_WAYS (~0ull)
+
+// Way holding tag, or -1 on a miss
+static int findWay(const vector<CacheLine>& set, unsigned int tag) {
+    int ways = set.size();
+    for (int i = 0; i < ways; ++i) {
+        if (set[i].valid && set[i].tag == tag)
+            return i;
+    }
+    return -1;
+}
+
+// Ways past the 64 a mask can describe are never partitioned
+static bool wayAllowed(unsigned long long mask, int way) {
+    return way >= 64 || ((mask >> way) & 1);
+}
+
+// First invalid way the mask allows, or -1 if they are all filled
+static int freeWay(const vector<CacheLine>& set, unsigned long long mask) {
+    int ways = set.size();
+    for (int i = 0; i < ways; ++i) {
+        if (!set[i].valid && wayAllowed(mask, i))
+            return i;
+    }
+    return -1;
+}
+
+// Way to fill on a miss: the first allowed invalid way, else the allowed way at the back of the list
+static int lruVictim(const vector<CacheLine>& set, const list<int>& lru, unsigned long long mask) {
+    int way = freeWay(set, mask);
+    if (way >= 0)
+        return way;
+
+    // Every valid way is on the LRU list, least recent at the back
+    for (auto it = lru.rbegin(); it != lru.rend(); ++it) {
+        if (wayAllowed(mask, *it))
+            return *it;
+    }
+    return -1;
+}
+
+// Move a way to the most recently used position
+static void touch(list<int>& lru, int way) {
+    lru.remove(way);
+    lru.push_front(way);
+}
+
+// Look up a tag in one set, filling it using LRU replacement on a miss (TLB levels)
+static cacheResType accessSet(vector<CacheLine>& set, list<int>& lru, unsigned int tag) {
+    int way = findWay(set, tag);
+    if (way >= 0) {
+        touch(lru, way);
+        return HIT;
+    }
+
+    way = lruVictim(set, lru, ALL_WAYS);
+    set[way] = { tag, true, false, 0, 0 };
+    touch(lru, way);
+    return MISS;
+}
+
+// Number of page-table levels walked for a page size (x86-64 style, 9 bits per level)
+static int walkLevels(int pageBytes) {
+    if (pageBytes == PAGE_1GB)
+        return 2;
+    if (pageBytes == PAGE_2MB)
+        return 3;
+    return 4;
+}
+
+CacheModel::CacheModel(int sets, int ways, int lineSize, const TimingConfig& timing, replacementPolicy policy)
+    : cache_(sets, vector<CacheLine>(ways, { 0, false, false, 0, 0 })),
+      lruLists_(sets),
+      numSets_(sets),
+      numWays_(ways),
+      lineSize_(lineSize),
+      policy_(policy),
+      randState_(0x05080902),
+      pow2_(isPow2(sets) && isPow2(lineSize)),
+      offsetBits_(log2i(lineSize)),
+      indexBits_(log2i(sets)),
+      timing_(timing),
+      pageSize_(PAGE_4KB),
+      injectPageWalks_(false),
+      pageTableBase_(PAGE_TABLE_BASE),
+      mshrEntries_(0),
+      dependentLoads_(false),
+      dataReady_(0),
+      now_(0),
+      cycleBase_(0),
+      countedUntil_(0),
+      dramBusyUntil_(0),
+      stats_()
+{
+    // Wider sets need more tag comparators, longer lines a wider data array
+    hitCycles_ = timing_.hitCycles + timing_.wayCycles * log2i(numWays_)
+        + timing_.lineCycles * max(0, log2i(lineSize_) - log2i(16));
+    transferCycles_ = (lineSize_ + timing_.dramBytesPerCycle - 1) / timing_.dramBytesPerCycle;
+    missCycles_ = timing_.missPenaltyCycles + timing_.dramCycles + transferCycles_;
+}
+
+void CacheModel::configureTLB(const vector<pair<int, int>>& levels, int pageBytes, bool injectWalks) {
+    tlb_.clear();
+    for (auto& geometry : levels) {
+        TLBLevel level;
+        level.sets = geometry.first;
+        level.ways = geometry.second;
+        level.entries.resize(level.sets, vector<CacheLine>(level.ways, { 0, false, false, 0, 0 }));
+        level.lruLists.resize(level.sets);
+        level.hits = 0;
+        level.misses = 0;
+        tlb_.push_back(level);
+    }
+
+    pageSize_ = pageBytes;
+    injectPageWalks_ = injectWalks;
+}
+
+bool CacheModel::setPageTableBase(unsigned int base) {
+    if (base > PAGE_TABLE_BASE)
+        return false;
+    pageTableBase_ = base;
+    return true;
+}
+
+// Occupancy is cache state, not a counter, so it survives resetStats(). Misses still in flight
+// keep their MSHRs; only the cycles after the reset are counted.
+void CacheModel::resetStats() {
+    countOutstanding(now_);
+    stats_ = CacheStats();
+    cycleBase_ = now_;
+    for (auto& level : tlb_) {
+        level.hits = 0;
+        level.misses = 0;
+    }
+    for (auto& t : tenants_) {
+        t.hits = 0;
+        t.misses = 0;
+    }
+}
+
+bool CacheModel::setWayMask(int tenant, unsigned long long mask) {
+    if (tenant < 0 || tenant >= MAX_TENANTS || numWays_ > 64)
+        return false;
+    if (numWays_ < 64)
+        mask &= (1ull << numWays_) - 1;
+    if (mask == 0)
+        return false;
+
+    if ((int)wayMasks_.size() <= tenant)
+        wayMasks_.resize(tenant + 1, ALL_WAYS);
+    wayMasks_[tenant] = mask;
+    return true;
+}
+
+void CacheModel::configureMSHRs(int entries, bool dependentLoads) {
+    mshrEntries_ = max(0, entries);
+    dependentLoads_ = dependentLoads;
+    dataReady_ = 0;
+    mshrs_.clear();
+    now_ = 0;
+    cycleBase_ = 0;
+    countedUntil_ = 0;
+    dramBusyUntil_ = 0;
+}
+
+// Add the misses in flight between the last accounted cycle and `until`
+void CacheModel::countOutstanding(unsigned long long until) {
+    if (until <= countedUntil_)
+        return;
+    if (!mshrs_.empty()) {
+        stats_.outstandingSum += mshrs_.size() * (until - countedUntil_);
+        stats_.outstandingCycles += until - countedUntil_;
+    }
+    countedUntil_ = until;
+}
+
+// Free every MSHR whose fill has completed by `until`, earliest first
+void CacheModel::retireMSHRs(unsigned long long until) {
+    while (true) {
+        size_t first = mshrs_.size();
+        for (size_t i = 0; i < mshrs_.size(); ++i) {
+            if (mshrs_[i].ready <= until && (first == mshrs_.size() || mshrs_[i].ready < mshrs_[first].ready))
+                first = i;
+        }
+        if (first == mshrs_.size())
+            break;
+
+        countOutstanding(mshrs_[first].ready);
+        mshrs_[first] = mshrs_.back();
+        mshrs_.pop_back();
+    }
+    countOutstanding(until);
+}
+
+void CacheModel::drainMSHRs() {
+    unsigned long long last = max(now_, dataReady_);
+    for (auto& m : mshrs_)
+        last = max(last, m.ready);
+    retireMSHRs(last);
+    now_ = last;
+    stats_.mshrCycles = now_ - cycleBase_;
+}
+
+// Issue one reference in the non-blocking model: misses to a line already being filled merge
+// into its MSHR, other misses take a free MSHR or stall the issue until one completes.
+// Latencies are those of the blocking model (a hit's data arrives hitCycles after issue, a fill's
+// hitCycles + missCycles after), so a trace with no overlap takes the same cycles in both.
+// Returns the outcome, which is a miss for a merged access even though the tag is present.
+cacheResType CacheModel::trackMiss(unsigned int addr, cacheResType res) {
+    // A dependent load waits for the data of the reference before it
+    if (dependentLoads_)
+        now_ = max(now_, dataReady_);
+    retireMSHRs(now_);
+
+    unsigned int block = pow2_ ? addr >> offsetBits_ : addr / lineSize_;
+    const MSHR* inFlight = nullptr;
+    for (auto& m : mshrs_) {
+        if (m.block == block) {
+            inFlight = &m;
+            break;
+        }
+    }
+
+    dataReady_ = now_ + hitCycles_;
+    if (inFlight) {
+        stats_.mergedMisses++;
+        dataReady_ = inFlight->ready;
+        res = MISS;
+    }
+    else if (res == MISS) {
+        if ((int)mshrs_.size() == mshrEntries_) {
+            unsigned long long earliest = mshrs_[0].ready;
+            for (auto& m : mshrs_)
+                earliest = min(earliest, m.ready);
+            stats_.mshrFullStalls++;
+            stats_.mshrStallCycles += earliest - now_;
+            now_ = earliest;
+            retireMSHRs(now_);
+        }
+
+        // Fills share the DRAM bandwidth: a line's transfer waits for the previous one to finish
+        unsigned long long ready = max(now_ + hitCycles_ + missCycles_, dramBusyUntil_ + transferCycles_);
+        dramBusyUntil_ = ready;
+        dataReady_ = ready;
+        mshrs_.push_back({ block, ready });
+    }
+
+    now_++;
+    stats_.mshrCycles = now_ - cycleBase_;
+    return res;
+}
+
+// Way to fill on a miss under the replacement policy. The order list is the recency order under
+// LRU and LFU and the fill order under FIFO, oldest at the back.
+int CacheModel::chooseVictim(const vector<CacheLine>& set, const list<int>& order, unsigned long long mask) {
+    if (policy_ == LRU || policy_ == FIFO)
+        return lruVictim(set, order, mask);
+
+    int way = freeWay(set, mask);
+    if (way >= 0)
+        return way;
+
+    if (policy_ == LFU) {
+        // Fewest uses since the fill, ties go to the least recently used
+        int victim = -1;
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            if (wayAllowed(mask, *it) && (victim < 0 || set[*it].uses < set[victim].uses))
+                victim = *it;
+        }
+        return victim;
+    }
+
+    // RANDOM: xorshift32, then a uniform pick among the allowed ways
+    randState_ ^= randState_ << 13;
+    randState_ ^= randState_ >> 17;
+    randState_ ^= randState_ << 5;
+    int ways = set.size();
+    int allowed = 0;
+    for (int i = 0; i < ways; ++i)
+        allowed += wayAllowed(mask, i);
+    int pick = randState_ % allowed;
+    for (int i = 0; i < ways; ++i) {
+        if (wayAllowed(mask, i) && pick-- == 0)
+            return i;
+    }
+    return -1;
+}
+
+TenantStats& CacheModel::tenantSlot(int id) {
+    if ((int)tenants_.size() <= id)
+        tenants_.resize(id + 1, TenantStats());
+    return tenants_[id];
+}
+
+cacheResType CacheModel::lookup(unsigned int addr, bool write, int tenant) {
+    unsigned int blockAddr, index, tag;
+    if (pow2_) {
+        blockAddr = addr >> offsetBits_;
+        index = blockAddr & (numSets_ - 1);
+        tag = blockAddr >> indexBits_;
+    }
+    else {
+        blockAddr = addr / lineSize_;
+        index = blockAddr % numSets_;
+        tag = blockAddr / numSets_;
+    }
+
+    vector<CacheLine>& set = cache_[index];
+    list<int>& lru = lruLists_[index];
+
+    int way = findWay(set, tag);
+    if (way >= 0) {
+        set[way].dirty = set[way].dirty || write;
+        set[way].uses++;
+        if (policy_ != FIFO)
+            touch(lru, way);
+        return HIT;
+    }
+
+    // Miss - the victim comes from the ways this tenant may fill
+    unsigned long long mask = tenant < (int)wayMasks_.size() ? wayMasks_[tenant] : ALL_WAYS;
+    way = chooseVictim(set, lru, mask);
+    CacheLine& line = set[way];
+    if (line.valid) {
+        if (line.dirty)
+            stats_.writebacks++;
+        tenantSlot(line.owner).occupancy--;
+    }
+    line = { tag, true, write, tenant, 1 };
+    tenantSlot(tenant).occupancy++;
+    touch(lru, way);
+    return MISS;
+}
+
+// Walk the page table, optionally sending each entry read through the cache
+void CacheModel::pageWalk(unsigned int addr, int tenant) {
+    stats_.pageWalks++;
+
+    int levels = walkLevels(pageSize_);
+    if (!injectPageWalks_) {
+        // Without the cache every entry read goes to DRAM
+        stats_.tlbCycles += (unsigned long long)levels * timing_.dramCycles;
+        return;
+    }
+
+    for (int level = 0; level < levels; ++level) {
+        // Entries of one level are laid out contiguously, indexed by the address bits above it;
+        // a span holds the leaf level for every 4KB page of the 32-bit space
+        unsigned long long prefix = (unsigned long long)addr >> (12 + 9 * (3 - level));
+        unsigned int pteAddr = pageTableBase_ + level * PAGE_TABLE_LEVEL_SPAN + prefix * PTE_SIZE;
+
+        stats_.walkRefs++;
+        cacheResType res = lookup(pteAddr, false, tenant);
+        stats_.tlbCycles += accessCycles(res);
+        if (res == HIT)
+            stats_.walkHits++;
+    }
+}
+
+// Look the page up level by level, walking the page table if every level misses
+void CacheModel::translate(unsigned int addr, int tenant) {
+    unsigned int vpn = addr / pageSize_;
+
+    for (size_t l = 0; l < tlb_.size(); ++l) {
+        TLBLevel& level = tlb_[l];
+        unsigned int index = vpn % level.sets;
+        unsigned int tag = vpn / level.sets;
+        if (l < timing_.tlbHitCycles.size())
+            stats_.tlbCycles += timing_.tlbHitCycles[l];
+
+        if (accessSet(level.entries[index], level.lruLists[index], tag) == HIT) {
+            level.hits++;
+            return;
+        }
+        level.misses++;
+    }
+
+    pageWalk(addr, tenant);
+}
+
+// Out-of-range tenant IDs are folded into tenant 0 rather than indexing past the tables
+static int checkTenant(int tenant) {
+    return tenant >= 0 && tenant < MAX_TENANTS ? tenant : 0;
+}
+
+cacheResType CacheModel::access(unsigned int addr, accessType type, int tenant) {
+    tenant = checkTenant(tenant);
+    if (!tlb_.empty())
+        translate(addr, tenant);
+
+    // cycles follow the blocking model, where a merged miss would have found its line filled
+    cacheResType tagRes = lookup(addr, type == WRITE, tenant);
+    cacheResType res = mshrEntries_ > 0 ? trackMiss(addr, tagRes) : tagRes;
+
+    stats_.accesses++;
+    if (type == WRITE)
+        stats_.writes++;
+    else
+        stats_.reads++;
+    if (res == HIT) {
+        stats_.hits++;
+        tenantSlot(tenant).hits++;
+    }
+    else {
+        stats_.misses++;
+        tenantSlot(tenant).misses++;
+    }
+    stats_.cycles += accessCycles(tagRes);
+    return res;
+}
+
+void CacheModel::accessBatch(const unsigned int* addrs, size_t count, const accessType* types, cacheResType* results,
+    const int* tenants) {
+    // Counters are kept locally and folded into the stats once per batch
+    unsigned long long hits = 0, tagHits = 0, writes = 0;
+    bool translating = !tlb_.empty();
+
+    for (size_t i = 0; i < count; ++i) {
+        bool write = types && types[i] == WRITE;
+        int tenant = tenants ? checkTenant(tenants[i]) : 0;
+        if (translating)
+            translate(addrs[i], tenant);
+
+        cacheResType tagRes = lookup(addrs[i], write, tenant);
+        cacheResType res = mshrEntries_ > 0 ? trackMiss(addrs[i], tagRes) : tagRes;
+        hits += res;
+        tagHits += tagRes;
+        writes += write;
+        if (results)
+            results[i] = res;
+        if (tenants) {
+            TenantStats& t = tenantSlot(tenant);
+            t.hits += res;
+            t.misses += 1 - res;
+        }
+    }
+
+    unsigned long long misses = count - hits;
+    stats_.accesses += count;
+    stats_.hits += hits;
+    stats_.misses += misses;
+    stats_.writes += writes;
+    stats_.reads += count - writes;
+    stats_.cycles += count * hitCycles_ + (count - tagHits) * missCycles_;
+    if (!tenants) {
+        TenantStats& t = tenantSlot(0);
+        t.hits += hits;
+        t.misses += misses;
+    }
+}
+
+// C interface - no exception may cross it, allocation failures come back as -1 (or NULL)
+
+static_assert(CACHESIM_MAX_TENANTS == MAX_TENANTS, "C and C++ tenant limits differ");
+static_assert(CACHESIM_LRU == LRU && CACHESIM_LFU == LFU && CACHESIM_FIFO == FIFO && CACHESIM_RANDOM == RANDOM,
+    "C and C++ replacement policies differ");
+
+struct cachesim {
+    CacheModel model;
+};
+
+cachesim* cachesim_create(int sets, int ways, int line_size) {
+    return cachesim_create_policy(sets, ways, line_size, CACHESIM_LRU);
+}
+
+cachesim* cachesim_create_policy(int sets, int ways, int line_size, int policy) {
+    if (sets <= 0 || ways <= 0 || line_size <= 0 || policy < CACHESIM_LRU || policy > CACHESIM_RANDOM)
+        return nullptr;
+    try {
+        return new cachesim{ CacheModel(sets, ways, line_size, TimingConfig(), (replacementPolicy)policy) };
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void cachesim_destroy(cachesim* sim) {
+    delete sim;
+}
+
+int cachesim_configure_tlb(cachesim* sim, const int* level_sets, const int* level_ways, int levels,
+    int page_size, int inject_walks) {
+    if (page_size != PAGE_4KB && page_size != PAGE_2MB && page_size != PAGE_1GB)
+        return -1;
+
+    for (int l = 0; l < levels; ++l) {
+        if (level_sets[l] <= 0 || level_ways[l] <= 0)
+            return -1;
+    }
+
+    try {
+        vector<pair<int, int>> geometry;
+        for (int l = 0; l < levels; ++l)
+            geometry.push_back({ level_sets[l], level_ways[l] });
+        sim->model.configureTLB(geometry, page_size, inject_walks != 0);
+        return 0;
+    }
+    catch (...) {
+        return -1;
+    }
+}
+
+int cachesim_access(cachesim* sim, unsigned int addr, int is_write) {
+    try {
+        return sim->model.access(addr, is_write ? WRITE : READ) == HIT;
+    }
+    catch (...) {
+        return -1;
+    }
+}
+
+int cachesim_access_tenant(cachesim* sim, unsigned int addr, int is_write, int tenant) {
+    if (tenant < 0 || tenant >= CACHESIM_MAX_TENANTS)
+        return -1;
+    try {
+        return sim->model.access(addr, is_write ? WRITE : READ, tenant) == HIT;
+    }
+    catch (...) {
+        return -1;
+    }
+}
+
+int cachesim_set_page_table_base(cachesim* sim, unsigned int base) {
+    return sim->model.setPageTableBase(base) ? 0 : -1;
+}
+
+void cachesim_configure_mshrs(cachesim* sim, int entries) {
+    sim->model.configureMSHRs(entries);
+}
+
+void cachesim_configure_dependent_mshrs(cachesim* sim, int entries) {
+    sim->model.configureMSHRs(entries, true);
+}
+
+void cachesim_drain_mshrs(cachesim* sim) {
+    sim->model.drainMSHRs();
+}
+
+int cachesim_set_way_mask(cachesim* sim, int tenant, unsigned long long mask) {
+    try {
+        return sim->model.setWayMask(tenant, mask) ? 0 : -1;
+    }
+    catch (...) {
+        return -1;
+    }
+}
+
+int cachesim_access_batch(cachesim* sim, const unsigned int* addrs, size_t count,
+    const unsigned char* is_write, unsigned char* hits) {
+    // Convert in fixed-size chunks so the per-address flags never need a heap buffer
+    const size_t chunk = 1024;
+    accessType types[chunk];
+    cacheResType results[chunk];
+
+    try {
+        for (size_t done = 0; done < count; done += chunk) {
+            size_t n = min(chunk, count - done);
+            if (is_write) {
+                for (size_t i = 0; i < n; ++i)
+                    types[i] = is_write[done + i] ? WRITE : READ;
+            }
+            sim->model.accessBatch(addrs + done, n, is_write ? types : nullptr, hits ? results : nullptr);
+            if (hits) {
+                for (size_t i = 0; i < n; ++i)
+                    hits[done + i] = results[i] == HIT;
+            }
+        }
+        return 0;
+    }
+    catch (...) {
+        return -1;
+    }
+}
+
+void cachesim_get_stats(const cachesim* sim, cachesim_stats* out) {
+    const CacheStats& s = sim->model.stats();
+    out->accesses = s.accesses;
+    out->hits = s.hits;
+    out->misses = s.misses;
+    out->reads = s.reads;
+    out->writes = s.writes;
+    out->writebacks = s.writebacks;
+    out->cycles = s.cycles;
+    out->tlb_cycles = s.tlbCycles;
+    out->page_walks = s.pageWalks;
+    out->walk_refs = s.walkRefs;
+    out->walk_hits = s.walkHits;
+    out->mshr_cycles = s.mshrCycles;
+    out->merged_misses = s.mergedMisses;
+    out->mshr_full_stalls = s.mshrFullStalls;
+    out->mshr_stall_cycles = s.mshrStallCycles;
+    out->mlp = s.mlp();
+}
+
+int cachesim_get_tenant_stats(const cachesim* sim, int tenant, cachesim_tenant_stats* out) {
+    const vector<TenantStats>& tenants = sim->model.tenantStats();
+    if (tenant < 0 || tenant >= (int)tenants.size())
+        return -1;
+    out->hits = tenants[tenant].hits;
+    out->misses = tenants[tenant].misses;
+    out->occupancy = tenants[tenant].occupancy;
+    return 0;
+}
+
+int cachesim_get_tlb_stats(const cachesim* sim, int level, cachesim_tlb_stats* out) {
+    const vector<TLBLevel>& levels = sim->model.tlbLevels();
+    if (level < 0 || level >= (int)levels.size())
+        return -1;
+    out->hits = levels[level].hits;
+    out->misses = levels[level].misses;
+    return 0;
+}
+
+void cachesim_reset_stats(cachesim* sim) {
+    sim->model.resetStats();
+}
@@ -0,0 +1,193 @@
+#ifndef CACHE_MODEL_H
+#define CACHE_MODEL_H
+
+#include <cstddef>
+#include <list>
+#include <utility>
+#include <vector>
+
+// Everything lives in namespace cachelib so the library can be embedded without name clashes
+namespace cachelib {
+
+const int PAGE_4KB = 4 * 1024;
+const int PAGE_2MB = 2 * 1024 * 1024;
+const int PAGE_1GB = 1024 * 1024 * 1024;
+const int PAGE_TABLE_LEVEL_SPAN = 8 * 1024 * 1024; // one level's entries for the whole 32-bit space
+const int PAGE_TABLE_SIZE = 4 * PAGE_TABLE_LEVEL_SPAN;
+const unsigned int PAGE_TABLE_BASE = 0u - PAGE_TABLE_SIZE; // default: the top 32 MB of the address space
+const int PTE_SIZE = 8;
+const int MAX_TENANTS = 256; // tenant IDs run from 0 to MAX_TENANTS - 1
+
+enum cacheResType { MISS = 0, HIT = 1 };
+enum accessType { READ = 0, WRITE = 1 };
+enum replacementPolicy { LRU = 0, LFU = 1, FIFO = 2, RANDOM = 3 };
+
+struct CacheLine {
+    unsigned int tag;
+    bool valid;
+    bool dirty;
+    int owner; // tenant that filled the line
+    unsigned int uses; // references since the fill (LFU)
+};
+
+struct TLBLevel {
+    int sets;
+    int ways;
+    std::vector<std::vector<CacheLine>> entries;
+    std::vector<std::list<int>> lruLists;
+    unsigned long long hits;
+    unsigned long long misses;
+};
+
+// Timing model, all latencies in cycles
+struct TimingConfig {
+    int hitCycles = 3;            // L1 hit latency for a direct-mapped cache with 16B lines
+    int wayCycles = 1;            // extra hit latency per doubling of associativity
+    int lineCycles = 1;           // extra hit latency per doubling of line size above 16B
+    int missPenaltyCycles = 10;   // miss handling overhead before the DRAM request goes out
+    int dramCycles = 100;         // DRAM access latency
+    int dramBytesPerCycle = 8;    // DRAM bandwidth, limits how fast a line can be filled
+    std::vector<int> tlbHitCycles = { 0, 7 }; // lookup latency per TLB level
+};
+
+struct CacheStats {
+    unsigned long long accesses;
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long reads;
+    unsigned long long writes;
+    unsigned long long writebacks; // dirty lines evicted
+    unsigned long long cycles;     // data access cycles of the blocking model
+    unsigned long long tlbCycles;  // translation cycles, page walks included
+    unsigned long long pageWalks;
+    unsigned long long walkRefs;   // page-table reads sent through the cache
+    unsigned long long walkHits;
+
+    // Non-blocking model (MSHRs configured): one reference issues per cycle, misses overlap.
+    // An access to a line whose fill is still in flight is a secondary miss: it counts in misses
+    // (and in mergedMisses), never in hits, since its data has not arrived yet.
+    unsigned long long mshrCycles;      // elapsed cycles since the last reset, final after drainMSHRs()
+    unsigned long long mergedMisses;    // accesses to a line whose fill was still in flight
+    unsigned long long mshrFullStalls;  // primary misses that found every MSHR busy
+    unsigned long long mshrStallCycles;
+    unsigned long long outstandingSum;  // sum over cycles of misses in flight
+    unsigned long long outstandingCycles; // cycles with at least one miss in flight
+
+    // Memory-level parallelism: average misses in flight while any are
+    double mlp() const { return outstandingCycles ? (double)outstandingSum / outstandingCycles : 0; }
+};
+
+struct MSHR {
+    unsigned int block;
+    unsigned long long ready; // cycle the fill completes
+};
+
+struct TenantStats {
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long occupancy; // lines currently filled by this tenant
+};
+
+// n-way set-associative cache with an optional multi-level TLB in front of it.
+// Geometry values are expected to be positive. The policy picks the victim among the ways a
+// tenant may fill once none of them is invalid; TLB levels always use LRU.
+class CacheModel {
+public:
+    CacheModel(int sets, int ways, int lineSize, const TimingConfig& timing = TimingConfig(),
+        replacementPolicy policy = LRU);
+
+    // One {sets, ways} pair per TLB level, first entry is L1. No levels disables translation.
+    void configureTLB(const std::vector<std::pair<int, int>>& levels, int pageBytes, bool injectWalks);
+    // Injected page-walk reads go to [base, base + PAGE_TABLE_SIZE); keep data addresses outside it.
+    // Returns false if the table would not fit below 4 GB.
+    bool setPageTableBase(unsigned int base);
+
+    // tenant is a stream ID (0 to MAX_TENANTS - 1) used for way partitioning and per-tenant stats;
+    // IDs outside that range are counted as tenant 0
+    cacheResType access(unsigned int addr, accessType type = READ, int tenant = 0);
+
+    // Same as calling access() for each address; types defaults to all reads and tenants to 0,
+    // results (if given) receives one outcome per address
+    void accessBatch(const unsigned int* addrs, size_t count, const accessType* types = nullptr,
+        cacheResType* results = nullptr, const int* tenants = nullptr);
+
+    // CAT-style partitioning: bit i allows the tenant to fill way i. Hits are not restricted.
+    // Returns false for a tenant outside 0 to MAX_TENANTS - 1, a cache with more than 64 ways
+    // or a mask that allows none of them.
+    bool setWayMask(int tenant, unsigned long long mask);
+
+    // Model a non-blocking cache with this many miss status holding registers; 0 (the default)
+    // keeps the blocking model where every miss completes before the next access.
+    // dependentLoads marks a trace where each address comes from the previous reference's data
+    // (pointer chasing): a reference cannot issue until that data has arrived.
+    void configureMSHRs(int entries, bool dependentLoads = false);
+    // Switch dependent loads on or off mid-trace (at a phase boundary); misses in flight are kept
+    void setDependentLoads(bool dependentLoads) { dependentLoads_ = dependentLoads; }
+    // Let every outstanding miss (and the last reference's data) arrive so mshrCycles and MLP cover the whole run
+    void drainMSHRs();
+
+    const CacheStats& stats() const { return stats_; }
+    const std::vector<TLBLevel>& tlbLevels() const { return tlb_; }
+    const std::vector<TenantStats>& tenantStats() const { return tenants_; }
+    void resetStats();
+
+    int sets() const { return numSets_; }
+    int ways() const { return numWays_; }
+    int lineSize() const { return lineSize_; }
+    replacementPolicy policy() const { return policy_; }
+
+    unsigned int hitCycles() const { return hitCycles_; }
+    unsigned int missCycles() const { return missCycles_; }
+    unsigned int accessCycles(cacheResType res) const { return res == HIT ? hitCycles_ : hitCycles_ + missCycles_; }
+
+private:
+    cacheResType lookup(unsigned int addr, bool write, int tenant);
+    void translate(unsigned int addr, int tenant);
+    void pageWalk(unsigned int addr, int tenant);
+    TenantStats& tenantSlot(int id);
+    int chooseVictim(const std::vector<CacheLine>& set, const std::list<int>& order, unsigned long long mask);
+    cacheResType trackMiss(unsigned int addr, cacheResType res);
+    void retireMSHRs(unsigned long long until);
+    void countOutstanding(unsigned long long until);
+
+    std::vector<std::vector<CacheLine>> cache_;
+    std::vector<std::list<int>> lruLists_; // recency order, or fill order under FIFO
+    int numSets_;
+    int numWays_;
+    int lineSize_;
+    replacementPolicy policy_;
+    unsigned int randState_; // victim choice under RANDOM, seeded per model so runs repeat
+
+    // Shift/mask decode when the geometry is a power of two
+    bool pow2_;
+    int offsetBits_;
+    int indexBits_;
+
+    TimingConfig timing_;
+    unsigned int hitCycles_;
+    unsigned int missCycles_;
+
+    std::vector<TLBLevel> tlb_;
+    int pageSize_;
+    bool injectPageWalks_;
+    unsigned int pageTableBase_;
+
+    int mshrEntries_;
+    bool dependentLoads_;
+    unsigned long long dataReady_;     // cycle the last reference's data arrives (dependent loads)
+    std::vector<MSHR> mshrs_;
+    unsigned long long now_;           // issue cycle of the next reference
+    unsigned long long cycleBase_;     // now_ at the last resetStats(), mshrCycles counts from here
+    unsigned long long countedUntil_;  // outstanding misses accounted up to this cycle
+    unsigned long long dramBusyUntil_; // the last fill's data transfer ends here
+    unsigned int transferCycles_;      // cycles one line occupies the DRAM bus
+
+    std::vector<unsigned long long> wayMasks_; // per tenant, all ways allowed if missing
+    std::vector<TenantStats> tenants_;
+
+    CacheStats stats_;
+};
+
+} // namespace cachelib
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef CACHE_MODEL_C_H
+#define CACHE_MODEL_C_H
+
+/* C interface to CacheModel, for tools that stream addresses from outside C++ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct cachesim cachesim;
+
+#define CACHESIM_MAX_TENANTS 256 /* tenant IDs run from 0 to CACHESIM_MAX_TENANTS - 1 */
+
+/* Replacement policies for cachesim_create_policy */
+#define CACHESIM_LRU    0
+#define CACHESIM_LFU    1
+#define CACHESIM_FIFO   2
+#define CACHESIM_RANDOM 3
+
+typedef struct {
+    unsigned long long accesses;
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long reads;
+    unsigned long long writes;
+    unsigned long long writebacks;
+    unsigned long long cycles;
+    unsigned long long tlb_cycles;
+    unsigned long long page_walks;
+    unsigned long long walk_refs; /* page-table reads sent through the cache */
+    unsigned long long walk_hits;
+    unsigned long long mshr_cycles;
+    unsigned long long merged_misses;
+    unsigned long long mshr_full_stalls;
+    unsigned long long mshr_stall_cycles;
+    double mlp;
+} cachesim_stats;
+
+typedef struct {
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long occupancy;
+} cachesim_tenant_stats;
+
+typedef struct {
+    unsigned long long hits;
+    unsigned long long misses;
+} cachesim_tlb_stats;
+
+/* Functions returning int return -1 when the model runs out of memory, besides the errors listed */
+
+/* Returns NULL if the geometry is not positive or allocation fails */
+cachesim* cachesim_create(int sets, int ways, int line_size);
+/* Same with one of the CACHESIM_LRU/LFU/FIFO/RANDOM policies (cachesim_create uses LRU);
+   also returns NULL for an unknown policy */
+cachesim* cachesim_create_policy(int sets, int ways, int line_size, int policy);
+void cachesim_destroy(cachesim* sim);
+
+/* level_sets/level_ways hold one entry per TLB level, L1 first. Returns 0 on success. */
+int cachesim_configure_tlb(cachesim* sim, const int* level_sets, const int* level_ways, int levels,
+    int page_size, int inject_walks);
+
+/* Injected page-walk reads use [base, base + 32 MB), by default the top 32 MB of the address
+   space; data addresses should stay outside it. Returns -1 if the table would not fit below 4 GB. */
+int cachesim_set_page_table_base(cachesim* sim, unsigned int base);
+
+/* Returns 1 on a hit, 0 on a miss, -1 on failure */
+int cachesim_access(cachesim* sim, unsigned int addr, int is_write);
+
+/* entries > 0 switches to the non-blocking model with that many MSHRs, 0 back to blocking.
+   Call cachesim_drain_mshrs before reading stats to account for misses still in flight. */
+void cachesim_configure_mshrs(cachesim* sim, int entries);
+/* Same, for a trace of dependent loads (pointer chasing): each access waits for the previous one's data */
+void cachesim_configure_dependent_mshrs(cachesim* sim, int entries);
+void cachesim_drain_mshrs(cachesim* sim);
+
+/* Same as cachesim_access for one tenant (a stream ID below CACHESIM_MAX_TENANTS); returns -1 for a bad tenant */
+int cachesim_access_tenant(cachesim* sim, unsigned int addr, int is_write, int tenant);
+
+/* Bit i of mask lets the tenant fill way i. Returns 0 on success, -1 if the cache cannot be
+   partitioned this way (more than 64 ways, or no allowed way). */
+int cachesim_set_way_mask(cachesim* sim, int tenant, unsigned long long mask);
+
+/* is_write may be NULL (all reads); hits may be NULL, otherwise receives 1/0 per address.
+   Returns 0, or -1 on failure (addresses before the failing one have been simulated). */
+int cachesim_access_batch(cachesim* sim, const unsigned int* addrs, size_t count,
+    const unsigned char* is_write, unsigned char* hits);
+
+void cachesim_get_stats(const cachesim* sim, cachesim_stats* out);
+/* Returns -1 for a tenant above the highest ID seen so far (by an access or an eviction). Lower IDs
+   that never accessed the cache return 0 with zeroed stats. */
+int cachesim_get_tenant_stats(const cachesim* sim, int tenant, cachesim_tenant_stats* out);
+/* level 0 is the L1 TLB; returns -1 past the last configured level */
+int cachesim_get_tlb_stats(const cachesim* sim, int level, cachesim_tlb_stats* out);
+void cachesim_reset_stats(cachesim* sim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
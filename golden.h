@@ -0,0 +1,216 @@
+#ifndef GOLDEN_H
+#define GOLDEN_H
+
+#include <vector>
+
+// Expected results for ./cache_simulator --check, regenerate with ./cache_simulator --golden > golden.h
+// param and values are described with RegressionRun in cache.cpp
+struct GoldenResult {
+    int experiment;
+    const char* generator;
+    int param;
+    std::vector<unsigned long long> values;
+};
+
+const std::vector<GoldenResult> goldenResults = {
+    { 1, "memGen1", 16, { 937500, 62500, 20000000 } },
+    { 1, "memGen1", 32, { 968750, 31250, 16562500 } },
+    { 1, "memGen1", 64, { 984375, 15625, 14843750 } },
+    { 1, "memGen1", 128, { 992187, 7813, 13984438 } },
+    { 2, "memGen1", 1, { 984375, 15625, 6843750 } },
+    { 2, "memGen1", 2, { 984375, 15625, 7843750 } },
+    { 2, "memGen1", 4, { 984375, 15625, 8843750 } },
+    { 2, "memGen1", 8, { 984375, 15625, 9843750 } },
+    { 2, "memGen1", 16, { 984375, 15625, 10843750 } },
+    { 3, "memGen1", 4096, { 984375, 15625, 13531, 245, 980, 938, 999755, 245, 0, 245 } },
+    { 3, "memGen1", 2097152, { 984375, 15625, 382, 1, 3, 0, 999999, 1, 0, 1 } },
+    { 3, "memGen1", 1073741824, { 984375, 15625, 257, 1, 2, 0, 999999, 1, 0, 1 } },
+    { 4, "memGen1", 0, { 15625, 16777216, 15625, 15625, 15625, 15625, 15625, 15625, 15625, 15625, 15625, 15625, 15625 } },
+    { 6, "memGen1", 1, { 0, 1000000, 1953125, 984375, 15624, 953064, 1953125, 1953125 } },
+    { 6, "memGen1", 2, { 0, 1000000, 1000061, 984375, 0, 0, 1953125, 1000061 } },
+    { 6, "memGen1", 4, { 0, 1000000, 1000061, 984375, 0, 0, 1953125, 1000061 } },
+    { 6, "memGen1", 8, { 0, 1000000, 1000061, 984375, 0, 0, 1953125, 1000061 } },
+    { 6, "memGen1", 16, { 0, 1000000, 1000061, 984375, 0, 0, 1953125, 1000061 } },
+    { 6, "memGen1", 32, { 0, 1000000, 1000061, 984375, 0, 0, 1953125, 1000061 } },
+    { 1, "memGen2", 16, { 998464, 1536, 13172032 } },
+    { 1, "memGen2", 32, { 999232, 768, 13087552 } },
+    { 1, "memGen2", 64, { 999616, 384, 13045312 } },
+    { 1, "memGen2", 128, { 999808, 192, 13024192 } },
+    { 2, "memGen2", 1, { 999616, 384, 5045312 } },
+    { 2, "memGen2", 2, { 999616, 384, 6045312 } },
+    { 2, "memGen2", 4, { 999616, 384, 7045312 } },
+    { 2, "memGen2", 8, { 999616, 384, 8045312 } },
+    { 2, "memGen2", 16, { 999616, 384, 9045312 } },
+    { 3, "memGen2", 4096, { 999616, 384, 682, 6, 24, 20, 999994, 6, 0, 6 } },
+    { 3, "memGen2", 2097152, { 999616, 384, 382, 1, 3, 0, 999999, 1, 0, 1 } },
+    { 3, "memGen2", 1073741824, { 999616, 384, 257, 1, 2, 0, 999999, 1, 0, 1 } },
+    { 4, "memGen2", 0, { 384, 16777216, 834030, 666947, 333179, 384, 384, 384, 384, 384, 384, 384, 384 } },
+    { 6, "memGen2", 1, { 999613, 387, 1045792, 3, 381, 45786, 48000, 48000 } },
+    { 6, "memGen2", 2, { 999605, 395, 1022026, 11, 370, 22020, 48007, 24234 } },
+    { 6, "memGen2", 4, { 999600, 400, 1010290, 16, 351, 10284, 48050, 12498 } },
+    { 6, "memGen2", 8, { 999588, 412, 1004564, 28, 325, 4558, 48272, 6773 } },
+    { 6, "memGen2", 16, { 999566, 434, 1001918, 50, 295, 1912, 50015, 4127 } },
+    { 6, "memGen2", 32, { 999526, 474, 1001776, 90, 278, 1770, 93145, 3985 } },
+    { 1, "memGen3", 16, { 981, 999019, 124890128 } },
+    { 1, "memGen3", 32, { 1029, 998971, 126882694 } },
+    { 1, "memGen3", 64, { 1018, 998982, 130879876 } },
+    { 1, "memGen3", 128, { 963, 999037, 138878662 } },
+    { 2, "memGen3", 1, { 1023, 998977, 122879286 } },
+    { 2, "memGen3", 2, { 1030, 998970, 123878460 } },
+    { 2, "memGen3", 4, { 1027, 998973, 124878814 } },
+    { 2, "memGen3", 8, { 1018, 998982, 125879876 } },
+    { 2, "memGen3", 16, { 1005, 998995, 126881410 } },
+    { 3, "memGen3", 4096, { 548, 999452, 117681112, 906123, 3624492, 2901297, 3906, 996094, 89971, 906123 } },
+    { 3, "memGen3", 2097152, { 1027, 998973, 1604, 32, 96, 90, 999968, 32, 0, 32 } },
+    { 3, "memGen3", 1073741824, { 1027, 998973, 257, 1, 2, 0, 999999, 1, 0, 1 } },
+    { 4, "memGen3", 0, { 32768, 855910, 999065, 998929, 998860, 998590, 998107, 997171, 995247, 991372, 984113, 969141, 938961 } },
+    { 6, "memGen3", 1, { 1025, 998975, 124871625, 2, 998972, 123871501, 124871625, 124871625 } },
+    { 6, "memGen3", 2, { 1024, 998976, 62435875, 3, 998971, 61435751, 124871632, 62435875 } },
+    { 6, "memGen3", 4, { 1022, 998978, 31218000, 5, 998969, 30217876, 124871667, 31218000 } },
+    { 6, "memGen3", 8, { 1015, 998985, 15609032, 12, 998965, 14608908, 124871821, 15609032 } },
+    { 6, "memGen3", 16, { 1009, 998991, 7991901, 18, 998957, 6991774, 127869336, 7991901 } },
+    { 6, "memGen3", 32, { 996, 999004, 7991901, 31, 998941, 6991646, 255736368, 7991901 } },
+    { 1, "memGen4", 16, { 999744, 256, 13028672 } },
+    { 1, "memGen4", 32, { 999872, 128, 13014592 } },
+    { 1, "memGen4", 64, { 999936, 64, 13007552 } },
+    { 1, "memGen4", 128, { 999968, 32, 13004032 } },
+    { 2, "memGen4", 1, { 999936, 64, 5007552 } },
+    { 2, "memGen4", 2, { 999936, 64, 6007552 } },
+    { 2, "memGen4", 4, { 999936, 64, 7007552 } },
+    { 2, "memGen4", 8, { 999936, 64, 8007552 } },
+    { 2, "memGen4", 16, { 999936, 64, 9007552 } },
+    { 3, "memGen4", 4096, { 999936, 64, 507, 1, 4, 0, 999999, 1, 0, 1 } },
+    { 3, "memGen4", 2097152, { 999936, 64, 382, 1, 3, 0, 999999, 1, 0, 1 } },
+    { 3, "memGen4", 1073741824, { 999936, 64, 257, 1, 2, 0, 999999, 1, 0, 1 } },
+    { 4, "memGen4", 0, { 64, 16777216, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64 } },
+    { 6, "memGen4", 1, { 995904, 4096, 1003849, 4032, 63, 3843, 8000, 8000 } },
+    { 6, "memGen4", 2, { 995904, 4096, 1000006, 4032, 0, 0, 8000, 4157 } },
+    { 6, "memGen4", 4, { 995904, 4096, 1000006, 4032, 0, 0, 8000, 4157 } },
+    { 6, "memGen4", 8, { 995904, 4096, 1000006, 4032, 0, 0, 8000, 4157 } },
+    { 6, "memGen4", 16, { 995904, 4096, 1000006, 4032, 0, 0, 8000, 4157 } },
+    { 6, "memGen4", 32, { 995904, 4096, 1000006, 4032, 0, 0, 8000, 4157 } },
+    { 1, "memGen5", 16, { 995904, 4096, 13458752 } },
+    { 1, "memGen5", 32, { 997952, 2048, 13233472 } },
+    { 1, "memGen5", 64, { 998976, 1024, 13120832 } },
+    { 1, "memGen5", 128, { 999488, 512, 13064512 } },
+    { 2, "memGen5", 1, { 998976, 1024, 5120832 } },
+    { 2, "memGen5", 2, { 998976, 1024, 6120832 } },
+    { 2, "memGen5", 4, { 998976, 1024, 7120832 } },
+    { 2, "memGen5", 8, { 998976, 1024, 8120832 } },
+    { 2, "memGen5", 16, { 998976, 1024, 9120832 } },
+    { 3, "memGen5", 4096, { 998968, 1032, 2094, 16, 64, 51, 999984, 16, 0, 16 } },
+    { 3, "memGen5", 2097152, { 998976, 1024, 382, 1, 3, 0, 999999, 1, 0, 1 } },
+    { 3, "memGen5", 1073741824, { 998976, 1024, 257, 1, 2, 0, 999999, 1, 0, 1 } },
+    { 4, "memGen5", 0, { 1024, 16777216, 15625, 15625, 15625, 15625, 1024, 1024, 1024, 1024, 1024, 1024, 1024 } },
+    { 6, "memGen5", 1, { 934464, 65536, 1062409, 64512, 1023, 62403, 128000, 128000 } },
+    { 6, "memGen5", 2, { 934464, 65536, 1000006, 64512, 0, 0, 128000, 65597 } },
+    { 6, "memGen5", 4, { 934464, 65536, 1000006, 64512, 0, 0, 128000, 65597 } },
+    { 6, "memGen5", 8, { 934464, 65536, 1000006, 64512, 0, 0, 128000, 65597 } },
+    { 6, "memGen5", 16, { 934464, 65536, 1000006, 64512, 0, 0, 128000, 65597 } },
+    { 6, "memGen5", 32, { 934464, 65536, 1000006, 64512, 0, 0, 128000, 65597 } },
+    { 1, "memGen6", 16, { 0, 1000000, 125000000 } },
+    { 1, "memGen6", 32, { 0, 1000000, 127000000 } },
+    { 1, "memGen6", 64, { 499999, 500001, 72000118 } },
+    { 1, "memGen6", 128, { 749999, 250001, 44500126 } },
+    { 2, "memGen6", 1, { 499999, 500001, 64000118 } },
+    { 2, "memGen6", 2, { 499999, 500001, 65000118 } },
+    { 2, "memGen6", 4, { 499999, 500001, 66000118 } },
+    { 2, "memGen6", 8, { 499999, 500001, 67000118 } },
+    { 2, "memGen6", 16, { 499999, 500001, 68000118 } },
+    { 3, "memGen6", 4096, { 499999, 500001, 4482, 64, 256, 237, 999936, 64, 0, 64 } },
+    { 3, "memGen6", 2097152, { 499999, 500001, 382, 1, 3, 0, 999999, 1, 0, 1 } },
+    { 3, "memGen6", 1073741824, { 499999, 500001, 257, 1, 2, 0, 999999, 1, 0, 1 } },
+    { 4, "memGen6", 0, { 4096, 16777216, 500001, 500001, 500001, 500001, 500001, 500001, 4096, 4096, 4096, 4096, 4096 } },
+    { 6, "memGen6", 1, { 0, 1000000, 62500125, 499999, 500000, 61500001, 62500125, 62500125 } },
+    { 6, "memGen6", 2, { 0, 1000000, 31250125, 499999, 499999, 30250001, 62500132, 31250125 } },
+    { 6, "memGen6", 4, { 0, 1000000, 15625125, 499999, 499997, 14625001, 62500164, 15625125 } },
+    { 6, "memGen6", 8, { 0, 1000000, 7812625, 499999, 499993, 6812501, 62500300, 7812625 } },
+    { 6, "memGen6", 16, { 0, 1000000, 4000125, 499999, 499985, 2999998, 64000815, 4000125 } },
+    { 6, "memGen6", 32, { 0, 1000000, 4000125, 499999, 499969, 2999870, 127999071, 4000125 } },
+    { 1, "memGenZipf", 16, { 619746, 380254, 55588448 } },
+    { 1, "memGenZipf", 32, { 619701, 380299, 56354086 } },
+    { 1, "memGenZipf", 64, { 619702, 380298, 57875164 } },
+    { 1, "memGenZipf", 128, { 547409, 452591, 70026466 } },
+    { 2, "memGenZipf", 1, { 597863, 402137, 52452166 } },
+    { 2, "memGenZipf", 2, { 614499, 385501, 51489118 } },
+    { 2, "memGenZipf", 4, { 619045, 380955, 51952690 } },
+    { 2, "memGenZipf", 8, { 619614, 380386, 52885548 } },
+    { 2, "memGenZipf", 16, { 619661, 380339, 53880002 } },
+    { 3, "memGenZipf", 4096, { 619031, 380969, 3707137, 256, 1024, 954, 472613, 527387, 527131, 256 } },
+    { 3, "memGenZipf", 2097152, { 619045, 380955, 382, 1, 3, 0, 999999, 1, 0, 1 } },
+    { 3, "memGenZipf", 1073741824, { 619045, 380955, 257, 1, 2, 0, 999999, 1, 0, 1 } },
+    { 4, "memGenZipf", 0, { 16379, 16777216, 699790, 623590, 545145, 464233, 380254, 293258, 201456, 105167, 16379, 16379, 16379 } },
+    { 6, "memGenZipf", 1, { 618915, 381085, 47619375, 130, 380954, 46619257, 47619375, 47619375 } },
+    { 6, "memGenZipf", 2, { 618807, 381193, 23809750, 238, 380943, 22809632, 47619382, 23809750 } },
+    { 6, "memGenZipf", 4, { 618529, 381471, 11904920, 516, 380905, 10904802, 47619429, 11904920 } },
+    { 6, "memGenZipf", 8, { 617987, 382013, 5952707, 1058, 380037, 4952589, 47619716, 5952707 } },
+    { 6, "memGenZipf", 16, { 616906, 383094, 3053101, 2139, 366062, 2052980, 48823192, 3053101 } },
+    { 6, "memGenZipf", 32, { 614747, 385253, 3047757, 4298, 366001, 2047508, 97498201, 3047757 } },
+    { 1, "memGenMatrix (column-major)", 16, { 499776, 500224, 69025088 } },
+    { 1, "memGenMatrix (column-major)", 32, { 749632, 250368, 41541952 } },
+    { 1, "memGenMatrix (column-major)", 64, { 0, 1000000, 131000000 } },
+    { 1, "memGenMatrix (column-major)", 128, { 0, 1000000, 139000000 } },
+    { 2, "memGenMatrix (column-major)", 1, { 0, 1000000, 123000000 } },
+    { 2, "memGenMatrix (column-major)", 2, { 0, 1000000, 124000000 } },
+    { 2, "memGenMatrix (column-major)", 4, { 0, 1000000, 125000000 } },
+    { 2, "memGenMatrix (column-major)", 8, { 0, 1000000, 126000000 } },
+    { 2, "memGenMatrix (column-major)", 16, { 0, 1000000, 127000000 } },
+    { 3, "memGenMatrix (column-major)", 4096, { 0, 1000000, 7023186, 512, 2048, 1973, 0, 1000000, 999488, 512 } },
+    { 3, "memGenMatrix (column-major)", 2097152, { 0, 1000000, 382, 1, 3, 0, 999999, 1, 0, 1 } },
+    { 3, "memGenMatrix (column-major)", 1073741824, { 0, 1000000, 257, 1, 2, 0, 999999, 1, 0, 1 } },
+    { 4, "memGenMatrix (column-major)", 0, { 32768, 16777216, 1000000, 1000000, 1000000, 125440, 125440, 125440, 125440, 125440, 125440, 32768, 32768 } },
+    { 6, "memGenMatrix (column-major)", 1, { 0, 1000000, 125000000, 0, 999999, 123999876, 125000000, 125000000 } },
+    { 6, "memGenMatrix (column-major)", 2, { 0, 1000000, 62500008, 0, 999998, 61499884, 125000007, 62500008 } },
+    { 6, "memGenMatrix (column-major)", 4, { 0, 1000000, 31250024, 0, 999996, 30249900, 125000042, 31250024 } },
+    { 6, "memGenMatrix (column-major)", 8, { 0, 1000000, 15625056, 0, 999992, 14624932, 125000196, 15625056 } },
+    { 6, "memGenMatrix (column-major)", 16, { 0, 1000000, 8000117, 0, 999984, 6999990, 128000792, 8000117 } },
+    { 6, "memGenMatrix (column-major)", 32, { 0, 1000000, 8000117, 0, 999968, 6999862, 255999280, 8000117 } },
+    { 1, "memGenMatrix (blocked 32x32)", 16, { 500000, 500000, 69000000 } },
+    { 1, "memGenMatrix (blocked 32x32)", 32, { 750000, 250000, 41500000 } },
+    { 1, "memGenMatrix (blocked 32x32)", 64, { 875000, 125000, 27750000 } },
+    { 1, "memGenMatrix (blocked 32x32)", 128, { 937500, 62500, 20875000 } },
+    { 2, "memGenMatrix (blocked 32x32)", 1, { 875000, 125000, 19750000 } },
+    { 2, "memGenMatrix (blocked 32x32)", 2, { 875000, 125000, 20750000 } },
+    { 2, "memGenMatrix (blocked 32x32)", 4, { 875000, 125000, 21750000 } },
+    { 2, "memGenMatrix (blocked 32x32)", 8, { 875000, 125000, 22750000 } },
+    { 2, "memGenMatrix (blocked 32x32)", 16, { 875000, 125000, 23750000 } },
+    { 3, "memGenMatrix (blocked 32x32)", 4096, { 875000, 125000, 36976, 512, 2048, 1973, 998030, 1970, 1458, 512 } },
+    { 3, "memGenMatrix (blocked 32x32)", 2097152, { 875000, 125000, 382, 1, 3, 0, 999999, 1, 0, 1 } },
+    { 3, "memGenMatrix (blocked 32x32)", 1073741824, { 875000, 125000, 257, 1, 2, 0, 999999, 1, 0, 1 } },
+    { 4, "memGenMatrix (blocked 32x32)", 0, { 32768, 16777216, 125000, 125000, 125000, 125000, 125000, 125000, 125000, 125000, 125000, 32768, 32768 } },
+    { 6, "memGenMatrix (blocked 32x32)", 1, { 0, 1000000, 15625000, 875000, 124999, 14624883, 15625000, 15625000 } },
+    { 6, "memGenMatrix (blocked 32x32)", 2, { 0, 1000000, 7812508, 875000, 62499, 6812391, 15625000, 7812508 } },
+    { 6, "memGenMatrix (blocked 32x32)", 4, { 0, 1000000, 3906274, 875000, 31249, 2906157, 15625000, 3906274 } },
+    { 6, "memGenMatrix (blocked 32x32)", 8, { 0, 1000000, 1953181, 875000, 15624, 953064, 15625000, 1953181 } },
+    { 6, "memGenMatrix (blocked 32x32)", 16, { 0, 1000000, 1000117, 875000, 0, 0, 15625000, 1000117 } },
+    { 6, "memGenMatrix (blocked 32x32)", 32, { 0, 1000000, 1000117, 875000, 0, 0, 15625000, 1000117 } },
+    { 1, "memGenChase", 16, { 0, 1000000, 125000000 } },
+    { 1, "memGenChase", 32, { 0, 1000000, 127000000 } },
+    { 1, "memGenChase", 64, { 0, 1000000, 131000000 } },
+    { 1, "memGenChase", 128, { 30634, 969366, 135140116 } },
+    { 2, "memGenChase", 1, { 0, 1000000, 123000000 } },
+    { 2, "memGenChase", 2, { 0, 1000000, 124000000 } },
+    { 2, "memGenChase", 4, { 0, 1000000, 125000000 } },
+    { 2, "memGenChase", 8, { 0, 1000000, 126000000 } },
+    { 2, "memGenChase", 16, { 0, 1000000, 127000000 } },
+    { 3, "memGenChase", 4096, { 0, 1000000, 5304940, 256, 1024, 979, 243934, 756066, 755810, 256 } },
+    { 3, "memGenChase", 2097152, { 0, 1000000, 382, 1, 3, 0, 999999, 1, 0, 1 } },
+    { 3, "memGenChase", 1073741824, { 0, 1000000, 257, 1, 2, 0, 999999, 1, 0, 1 } },
+    { 4, "memGenChase", 0, { 16384, 16777216, 1000000, 1000000, 1000000, 1000000, 1000000, 1000000, 1000000, 1000000, 16384, 16384, 16384 } },
+    { 6, "memGenChase", 1, { 0, 1000000, 125000000, 0, 0, 0, 125000000, 125000000 } },
+    { 6, "memGenChase", 2, { 0, 1000000, 125000000, 0, 0, 0, 125000000, 125000000 } },
+    { 6, "memGenChase", 4, { 0, 1000000, 125000000, 0, 0, 0, 125000000, 125000000 } },
+    { 6, "memGenChase", 8, { 0, 1000000, 125000000, 0, 0, 0, 125000000, 125000000 } },
+    { 6, "memGenChase", 16, { 0, 1000000, 125000000, 0, 0, 0, 125000000, 125000000 } },
+    { 6, "memGenChase", 32, { 0, 1000000, 125000000, 0, 0, 0, 125000000, 125000000 } },
+    { 5, "memGen2/memGen3", 0, { 419585, 80415, 320, 368, 499632, 704 } },
+    { 5, "memGen2/memGen3", 8, { 499616, 384, 384, 267, 499733, 512 } },
+    { 5, "memGen2/memGen3", 12, { 499616, 384, 384, 130, 499870, 256 } },
+    { 5, "memGen2/memGen3", 14, { 499616, 384, 384, 67, 499933, 128 } },
+    { 5, "memGenZipf/memGenChase", 0, { 250344, 249656, 383, 0, 500000, 641 } },
+    { 5, "memGenZipf/memGenChase", 8, { 267360, 232640, 512, 0, 500000, 512 } },
+    { 5, "memGenZipf/memGenChase", 12, { 291581, 208419, 768, 0, 500000, 256 } },
+    { 5, "memGenZipf/memGenChase", 14, { 300961, 199039, 896, 0, 500000, 128 } },
+};
+
+#endif
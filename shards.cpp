@@ -0,0 +1,136 @@
+#include "shards.h"
+
+#include <algorithm>
+using namespace std;
+using namespace cachelib;
+
+// splitmix64 finalizer - spreads neighbouring block addresses over the whole hash range
+static unsigned long long hashBlock(unsigned int block) {
+    unsigned long long h = block + 0x9E3779B97F4A7C15ull;
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+    return h ^ (h >> 31);
+}
+
+ShardsMRC::ShardsMRC(int lineSize, size_t maxSamples, double initialRate,
+    unsigned long long maxCacheBytes, size_t buckets)
+    : lineSize_(lineSize),
+      maxSamples_(max((size_t)1, maxSamples)),
+      threshold_((unsigned long long)(min(1.0, max(0.0, initialRate)) * SHARDS_MODULUS)),
+      fenwick_(4 * maxSamples_ + 1, 0),
+      now_(0),
+      bucketBlocks_(max(1ull, maxCacheBytes / lineSize / max((size_t)1, buckets))),
+      histogram_(max((size_t)1, buckets), 0.0),
+      coldMisses_(0),
+      norm_(1.0),
+      references_(0)
+{
+}
+
+// Fenwick tree indexed by access time; index 0 is unused
+void ShardsMRC::fenwickAdd(size_t pos, int delta) {
+    for (size_t i = pos + 1; i < fenwick_.size(); i += i & -i)
+        fenwick_[i] += delta;
+}
+
+unsigned long long ShardsMRC::fenwickSum(size_t pos) const {
+    unsigned long long sum = 0;
+    for (size_t i = pos; i > 0; i -= i & -i)
+        sum += fenwick_[i];
+    return sum;
+}
+
+// Out of time slots - renumber the live blocks 0..n-1 in access order
+void ShardsMRC::compact() {
+    vector<pair<size_t, unsigned int>> live;
+    live.reserve(lastAccess_.size());
+    for (auto& entry : lastAccess_)
+        live.push_back({ entry.second, entry.first });
+    sort(live.begin(), live.end());
+
+    fill(fenwick_.begin(), fenwick_.end(), 0);
+    for (size_t t = 0; t < live.size(); ++t) {
+        lastAccess_[live[t].second] = t;
+        fenwickAdd(t, 1);
+    }
+    now_ = live.size();
+}
+
+// Too many samples - stop tracking the largest hash value and lower the rate to exclude it
+void ShardsMRC::evictLargestHash() {
+    unsigned long long largest = byHash_.top().first;
+    while (!byHash_.empty() && byHash_.top().first == largest) {
+        auto it = lastAccess_.find(byHash_.top().second);
+        fenwickAdd(it->second, -1);
+        lastAccess_.erase(it);
+        byHash_.pop();
+    }
+
+    // Counts gathered at the old rate now stand for proportionally fewer references
+    norm_ *= (double)largest / threshold_;
+    threshold_ = largest;
+}
+
+void ShardsMRC::access(unsigned int addr) {
+    references_++;
+
+    unsigned int block = addr / lineSize_;
+    unsigned long long hash = hashBlock(block) % SHARDS_MODULUS;
+    if (hash >= threshold_)
+        return;
+
+    if (now_ + 1 >= fenwick_.size())
+        compact();
+
+    auto it = lastAccess_.find(block);
+    if (it == lastAccess_.end()) {
+        coldMisses_ += 1.0 / norm_;
+        lastAccess_[block] = now_;
+        fenwickAdd(now_++, 1);
+        byHash_.push({ hash, block });
+        if (lastAccess_.size() > maxSamples_)
+            evictLargestHash();
+        return;
+    }
+
+    // Sampled blocks touched since the last access, scaled up to the whole trace
+    size_t last = it->second;
+    unsigned long long distance = lastAccess_.size() - fenwickSum(last + 1);
+    unsigned long long bucket = (unsigned long long)(distance / samplingRate()) / bucketBlocks_;
+    if (bucket < histogram_.size())
+        histogram_[bucket] += 1.0 / norm_;
+    else
+        coldMisses_ += 1.0 / norm_;
+
+    fenwickAdd(last, -1);
+    it->second = now_;
+    fenwickAdd(now_++, 1);
+}
+
+void ShardsMRC::accessBatch(const unsigned int* addrs, size_t count) {
+    for (size_t i = 0; i < count; ++i)
+        access(addrs[i]);
+}
+
+double ShardsMRC::missRatio(unsigned long long cacheBytes) const {
+    size_t buckets = min((unsigned long long)histogram_.size(), cacheBytes / lineSize_ / bucketBlocks_);
+
+    double hits = 0, total = coldMisses_;
+    for (size_t b = 0; b < histogram_.size(); ++b) {
+        total += histogram_[b];
+        if (b < buckets)
+            hits += histogram_[b];
+    }
+    if (total <= 0)
+        return 0;
+
+    // SHARDS_adj: the sample holds more or fewer references than the rate predicts;
+    // credit the difference to the smallest distances, where it does the least damage
+    double expected = references_ * samplingRate() / norm_;
+    double adjust = buckets > 0 ? expected - total : 0;
+    if (total + adjust <= 0)
+        return 1;
+
+    double ratio = 1.0 - (hits + adjust) / (total + adjust);
+    return min(1.0, max(0.0, ratio));
+}
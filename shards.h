@@ -0,0 +1,69 @@
+#ifndef SHARDS_H
+#define SHARDS_H
+
+#include <cstddef>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cachelib {
+
+// Approximate miss-ratio curve for a fully associative LRU cache in one pass, using
+// fixed-size SHARDS: block addresses are sampled by hash, at most maxSamples blocks are
+// tracked, and the sampling rate drops whenever that bound would be exceeded.
+// Reuse distances come from a Fenwick tree over last-access times, so memory stays constant
+// however long the trace is.
+class ShardsMRC {
+public:
+    // Distances are bucketed over cache sizes up to maxCacheBytes in `buckets` equal steps.
+    // At the default initial rate every block is tracked (exact results) until the trace
+    // touches more than maxSamples blocks.
+    ShardsMRC(int lineSize, size_t maxSamples = 32768, double initialRate = 1.0,
+        unsigned long long maxCacheBytes = 64ull * 1024 * 1024, size_t buckets = 16384);
+
+    void access(unsigned int addr);
+    void accessBatch(const unsigned int* addrs, size_t count);
+
+    // Estimated miss ratio (0 - 1) of a cacheBytes fully associative LRU cache,
+    // rounded down to the bucket granularity
+    double missRatio(unsigned long long cacheBytes) const;
+
+    unsigned long long references() const { return references_; }
+    double samplingRate() const { return (double)threshold_ / SHARDS_MODULUS; }
+    // Cache bytes one sampled block stands for; sizes only a few steps wide are coarse
+    double samplingStep() const { return lineSize_ / samplingRate(); }
+    size_t trackedBlocks() const { return lastAccess_.size(); }
+    unsigned long long bucketBytes() const { return bucketBlocks_ * lineSize_; }
+
+private:
+    static const unsigned long long SHARDS_MODULUS = 1ull << 24;
+
+    void fenwickAdd(size_t pos, int delta);
+    unsigned long long fenwickSum(size_t pos) const; // live blocks with time < pos
+    void compact();
+    void evictLargestHash();
+
+    int lineSize_;
+    size_t maxSamples_;
+    unsigned long long threshold_;  // block sampled when hash % SHARDS_MODULUS < threshold_
+
+    // block -> time of its last sampled access, and sampled blocks ordered by hash
+    std::unordered_map<unsigned int, size_t> lastAccess_;
+    std::priority_queue<std::pair<unsigned long long, unsigned int>> byHash_;
+
+    std::vector<int> fenwick_;      // one bit per time slot that is some block's last access
+    size_t now_;
+
+    unsigned long long bucketBlocks_;
+    // Counts are stored unnormalized: the real count is value * norm_, so lowering the
+    // sampling rate rescales everything by shrinking norm_ instead of touching every bucket
+    std::vector<double> histogram_; // reuse-distance counts per bucket
+    double coldMisses_;             // first touches and distances beyond the last bucket
+    double norm_;
+    unsigned long long references_;
+};
+
+} // namespace cachelib
+
+#endif
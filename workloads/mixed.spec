@@ -0,0 +1,6 @@
+# Example phase mix: <generator> <references> [key=value ...]
+# Key-value lookups against a hot set, a column scan, then a linked-list walk.
+zipf     200000  footprint=1048576 alpha=0.99 item=64
+matrix   100000  rows=512 cols=512 elem=8 order=col
+chase    100000  nodes=16384 node=64
+memGen2  50000